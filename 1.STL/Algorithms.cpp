@@ -1,13 +1,20 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <optional>
+#include <random>
 
-// Function to print a vector
+#include "Buffered_Output.h"
+#include "Eytzinger_Index.h"
+#include "Fused_Pipeline.h"
+#include "Parallel_Algorithms.h"
+#include "Radix_Sort.h"
+#include "Simd_Kernels.h"
+#include "Stream_Statistics.h"
+
+// Function to print a vector (through the shared output buffer, see Buffered_Output.h)
 void printVector(const std::vector<int>& vec) {
-    for (int num : vec) {
-        std::cout << num << " ";
-    }
-    std::cout << std::endl;
+    writeLine(standardOutput(), vec);
 }
 
 int main() {
@@ -41,14 +48,111 @@ int main() {
     std::cout << "Sorted vector in descending order: ";
     printVector(vec);
 
-    // Searching for an element in the vector
+    // Searching for an element in the vector (it is sorted in descending order now,
+    // so binary_search needs the same comparator)
     int target = 5;
-    bool found = std::binary_search(vec.begin(), vec.end(), target);
+    bool found = std::binary_search(vec.begin(), vec.end(), target, std::greater<int>());
     if (found) {
         std::cout << "Element " << target << " found in the vector." << std::endl;
     } else {
         std::cout << "Element " << target << " not found in the vector." << std::endl;
     }
 
+    // Parallel versions of the same algorithms (see Parallel_Algorithms.h)
+    // They split the work over a pool of threads, which only pays off on large vectors,
+    // so this part uses a million random numbers and checks the results against std.
+    ThreadPool pool;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, 1000000);
+    std::vector<int> big(1000000);
+    for (int& num : big) {
+        num = dis(gen);
+    }
+    std::vector<int> serial = big;
+    std::cout << "Parallel algorithms on " << big.size() << " elements with " << pool.size() << " threads:" << std::endl;
+
+    parallelForEach(pool, big.begin(), big.end(), [](int &n){ n++; });
+    std::for_each(serial.begin(), serial.end(), [](int &n){ n++; });
+    std::cout << "for_each increment matches std: " << (big == serial ? "yes" : "no") << std::endl;
+
+    auto parallelIt = parallelFindIf(pool, big.begin(), big.end(), [](int n){ return n > 999990; });
+    auto serialIt = std::find_if(serial.begin(), serial.end(), [](int n){ return n > 999990; });
+    std::cout << "First element greater than 999990 is at position " << (parallelIt - big.begin())
+              << ", std finds position " << (serialIt - serial.begin()) << std::endl;
+
+    // The same increment and search with the explicit vector kernels (see Simd_Kernels.h)
+    // on copies, so the vectors used below keep their values
+    std::vector<int> simd = serial;
+    std::vector<int> incremented = serial;
+    std::for_each(incremented.begin(), incremented.end(), [](int &n){ n++; });
+    simdAdd(simd.data(), simd.size(), 1);
+    std::cout << "SIMD increment (" << simdLevelName(simdLevel()) << ") matches std: "
+              << (simd == incremented ? "yes" : "no") << std::endl;
+    std::cout << "SIMD search finds the first element greater than 999990 at position "
+              << simdFindFirstGreater(simd.data(), simd.size(), 999990) << std::endl;
+
+    // A fused pipeline (see Fused_Pipeline.h) increments and searches in one pass, and stops at the match
+    // instead of incrementing a copy of the vector with for_each and then searching it with find_if
+    std::optional<int> fusedHit = from(serial) | transform([](int n) { return n + 1; })
+                                               | findFirst([](int n) { return n > 999990; });
+    std::vector<int> stepByStep = serial;
+    std::for_each(stepByStep.begin(), stepByStep.end(), [](int &n){ n++; });
+    auto stepIt = std::find_if(stepByStep.begin(), stepByStep.end(), [](int n){ return n > 999990; });
+    std::optional<int> stepHit;
+    if (stepIt != stepByStep.end()) {
+        stepHit = *stepIt;
+    }
+    if (fusedHit) {
+        std::cout << "Fused increment and search finds " << *fusedHit;
+    } else {
+        std::cout << "Fused increment and search finds no element greater than 999990";
+    }
+    std::cout << ", matches std: " << (fusedHit == stepHit ? "yes" : "no") << std::endl;
+
+    // The largest values and the median without sorting (see Stream_Statistics.h)
+    TopK largest(3);
+    QuantileSketch sketch;
+    for (int num : serial) {
+        largest.push(num);
+        sketch.push(num);
+    }
+    std::cout << "Three largest elements: ";
+    printVector(largest.values());
+    std::cout << "Approximate median: " << sketch.quantile(0.5) << ", exact median: " << exactQuantile(serial, 0.5)
+              << std::endl;
+
+    parallelSort(pool, big.begin(), big.end());
+    std::sort(serial.begin(), serial.end());
+    std::cout << "Sort matches std: " << (big == serial ? "yes" : "no") << std::endl;
+
+    // Radix sort (see Radix_Sort.h) orders ints without comparisons, in either direction
+    std::vector<int> radixSorted = serial;
+    std::vector<int> scratch;
+    std::shuffle(radixSorted.begin(), radixSorted.end(), gen);
+    radixSort(radixSorted, scratch);
+    std::cout << "Radix sort matches std: " << (radixSorted == serial ? "yes" : "no") << std::endl;
+    radixSort(radixSorted, scratch, SortOrder::Descending);
+    std::cout << "Descending radix sort is ordered: "
+              << (std::is_sorted(radixSorted.begin(), radixSorted.end(), std::greater<int>()) ? "yes" : "no")
+              << std::endl;
+
+    // A search index with a cache-friendly layout (see Eytzinger_Index.h) takes the vector
+    // in either order and answers many lookups at once
+    EytzingerIndex index(big);
+    std::vector<int> probes = {5, 500000, 2000000};
+    std::vector<char> probeHits;
+    index.contains(probes, probeHits);
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        std::cout << "Index lookup of " << probes[i] << ": " << (probeHits[i] ? "found" : "not found") << std::endl;
+    }
+
+    std::vector<int> targets = {5, 500000, 2000000};
+    std::vector<char> foundTargets(targets.size());
+    parallelBinarySearch(pool, big.begin(), big.end(), targets.begin(), targets.end(), foundTargets.begin());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        std::cout << "Element " << targets[i] << (foundTargets[i] ? " found" : " not found") << " in the big vector."
+                  << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+// Allocation profiler: per-scope heap statistics from an interposed global operator new
+//
+// Including this header replaces the global operator new/delete (all forms). Every block
+// gets a 16-byte header recording its size and the scope it was allocated in, and the
+// following is counted per scope:
+//  - allocations and deallocations
+//  - bytes allocated
+//  - live bytes and peak live bytes (frees are charged to the scope that allocated; see
+//    AllocationStats for the peak of scopes used by several threads)
+//
+// Scopes are named regions opened with an RAII object and can be nested; each allocation
+// is charged to the innermost open scope of its thread, so every row of the report is
+// exclusive of its nested scopes. Allocations outside any scope go to "(no scope)".
+//     AllocationReport report(std::cout);         // prints the table when main() returns
+//     AllocationScope scope("vectorExamples");    // at the top of a function
+//
+// Every thread counts into its own block of per-scope counters, which only that thread
+// writes: an allocation is a few plain additions on thread-private cache lines, with no
+// atomic read-modify-write and no sharing between threads, so the profiler is cheap enough
+// to leave enabled in perf builds. The blocks are added up when the report is printed (or
+// statsFor() is called). The remaining cost is the 16-byte header on every block, which can
+// move small requests into a larger size class. Compile with -DDISABLE_ALLOCATION_PROFILER
+// to remove the interposer.
+//
+// Because it replaces the global operators, this header must be included in exactly
+// one translation unit of a program (every program in this folder is a single file).
+
+// Totals for one scope, summed over all threads
+struct AllocationStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytesAllocated = 0;
+    std::int64_t liveBytes = 0;
+    // Sum of each thread's own peak: exact for a scope used by one thread, an upper bound
+    // when several threads allocate or free its blocks
+    std::int64_t peakLiveBytes = 0;
+};
+
+class AllocationProfiler {
+public:
+    static constexpr int kMaxScopes = 64;
+
+    using Stats = AllocationStats;
+
+    // Returns the id of the scope with this name, registering it on first use.
+    // The name must outlive the program (string literals do).
+    static int scopeId(const char* name) {
+        int count = scopeCount.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+            if (std::strcmp(names[i], name) == 0) {
+                return i;
+            }
+        }
+        // Registration is rare, so a simple spin lock is enough
+        while (registering.test_and_set(std::memory_order_acquire)) {
+        }
+        count = scopeCount.load(std::memory_order_relaxed);
+        int id = -1;
+        for (int i = 0; i < count; ++i) {
+            if (std::strcmp(names[i], name) == 0) {
+                id = i;
+            }
+        }
+        if (id < 0) {
+            id = count < kMaxScopes ? count : 0; // Too many scopes: fall back to "(no scope)"
+            if (count < kMaxScopes) {
+                names[id] = name;
+                scopeCount.store(count + 1, std::memory_order_release);
+            }
+        }
+        registering.clear(std::memory_order_release);
+        return id;
+    }
+
+    static int& currentScope() {
+        thread_local int scope = 0;
+        return scope;
+    }
+
+    static void recordAllocation(int scope, std::size_t bytes) {
+        Counters& c = threadCounters()[scope];
+        add(c.allocations, 1);
+        add(c.bytesAllocated, bytes);
+        const std::int64_t live = add(c.liveBytes, static_cast<std::int64_t>(bytes));
+        if (live > c.peakLiveBytes.load(std::memory_order_relaxed)) {
+            c.peakLiveBytes.store(live, std::memory_order_relaxed);
+        }
+    }
+
+    // Charged to the scope that allocated, in the counters of the thread that frees
+    static void recordDeallocation(int scope, std::size_t bytes) {
+        Counters& c = threadCounters()[scope];
+        add(c.deallocations, 1);
+        add(c.liveBytes, -static_cast<std::int64_t>(bytes));
+    }
+
+    // Prints one row per scope that saw any allocation
+    static void printReport(std::ostream& out) {
+        out << "Heap allocations per scope:\n";
+        out << std::left << std::setw(36) << "scope" << std::right << std::setw(10) << "allocs" << std::setw(10)
+            << "frees" << std::setw(14) << "bytes" << std::setw(12) << "live" << std::setw(12) << "peak live" << "\n";
+        int count = scopeCount.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+            const Stats s = total(i);
+            if (s.allocations == 0 && s.deallocations == 0) {
+                continue;
+            }
+            out << std::left << std::setw(36) << names[i] << std::right << std::setw(10) << s.allocations
+                << std::setw(10) << s.deallocations << std::setw(14) << s.bytesAllocated << std::setw(12)
+                << s.liveBytes << std::setw(12) << s.peakLiveBytes << "\n";
+        }
+        out << std::flush;
+    }
+
+    // The totals of a scope so far
+    static Stats statsFor(const char* name) {
+        return total(scopeId(name));
+    }
+
+private:
+    // Counters of one scope in one thread. Only the owning thread writes them, with a load
+    // and a store instead of an atomic read-modify-write; they are atomics so that the
+    // report can read them from another thread.
+    struct Counters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> deallocations{0};
+        std::atomic<std::uint64_t> bytesAllocated{0};
+        std::atomic<std::int64_t> liveBytes{0};
+        std::atomic<std::int64_t> peakLiveBytes{0};
+    };
+
+    // One per thread, kept (and still counted) after the thread exits
+    struct ThreadBlock {
+        Counters scopes[kMaxScopes];
+        ThreadBlock* next = nullptr;
+    };
+
+    template <typename T, typename D>
+    static T add(std::atomic<T>& counter, D delta) {
+        const T value = counter.load(std::memory_order_relaxed) + static_cast<T>(delta);
+        counter.store(value, std::memory_order_relaxed);
+        return value;
+    }
+
+    static Counters* threadCounters() {
+        thread_local ThreadBlock* block = nullptr;
+        if (block == nullptr) {
+            // From malloc, since this runs inside operator new
+            void* memory = std::malloc(sizeof(ThreadBlock));
+            if (memory == nullptr) {
+                std::abort();
+            }
+            block = new (memory) ThreadBlock();
+            ThreadBlock* head = threads.load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!threads.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+        }
+        return block->scopes;
+    }
+
+    static Stats total(int scope) {
+        Stats s;
+        for (ThreadBlock* block = threads.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+            const Counters& c = block->scopes[scope];
+            s.allocations += c.allocations.load(std::memory_order_relaxed);
+            s.deallocations += c.deallocations.load(std::memory_order_relaxed);
+            s.bytesAllocated += c.bytesAllocated.load(std::memory_order_relaxed);
+            s.liveBytes += c.liveBytes.load(std::memory_order_relaxed);
+            s.peakLiveBytes += c.peakLiveBytes.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    static inline std::atomic<ThreadBlock*> threads{nullptr};
+    static inline const char* names[kMaxScopes] = {"(no scope)"};
+    static inline std::atomic<int> scopeCount{1};
+    static inline std::atomic_flag registering = ATOMIC_FLAG_INIT;
+};
+
+// Charges the allocations of the current thread to a named scope until destroyed
+class AllocationScope {
+public:
+    explicit AllocationScope(const char* name) : previous(AllocationProfiler::currentScope()) {
+        AllocationProfiler::currentScope() = AllocationProfiler::scopeId(name);
+    }
+
+    ~AllocationScope() {
+        AllocationProfiler::currentScope() = previous;
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    int previous;
+};
+
+// Prints the report when it goes out of scope; create one at the top of main()
+class AllocationReport {
+public:
+    explicit AllocationReport(std::ostream& out) : out(out) {}
+
+    ~AllocationReport() {
+#ifndef DISABLE_ALLOCATION_PROFILER
+        out << "----------------------------------------\n";
+        AllocationProfiler::printReport(out);
+#endif
+    }
+
+private:
+    std::ostream& out;
+};
+
+#ifndef DISABLE_ALLOCATION_PROFILER
+
+namespace allocation_profiler_detail {
+
+// The header in front of every block; 16 bytes keeps the default alignment
+struct BlockHeader {
+    std::uint64_t size;
+    std::uint32_t scope;
+    std::uint32_t offset; // Distance from the start of the malloc'ed block to the user pointer
+};
+
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader must keep 16-byte alignment");
+
+// Over-aligned requests get alignment - 1 spare bytes from malloc and are aligned by hand
+// (the offset in the header finds the start again), so every block goes back to std::free;
+// std::aligned_alloc is not available on every runtime (MinGW/MSVCRT has none)
+inline void* allocate(std::size_t size, std::size_t alignment) {
+    const std::size_t padding = alignment > alignof(std::max_align_t) ? alignment - 1 : 0;
+    if (size > static_cast<std::size_t>(-1) - sizeof(BlockHeader) - padding) {
+        return nullptr;
+    }
+    char* raw = static_cast<char*>(std::malloc(sizeof(BlockHeader) + padding + size));
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(raw) + sizeof(BlockHeader);
+    const std::uintptr_t aligned = padding == 0 ? first : (first + padding) & ~static_cast<std::uintptr_t>(padding);
+    char* user = raw + (aligned - reinterpret_cast<std::uintptr_t>(raw));
+    const std::size_t offset = static_cast<std::size_t>(user - raw);
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(user) - 1;
+    int scope = AllocationProfiler::currentScope();
+    header->size = size;
+    header->scope = static_cast<std::uint32_t>(scope);
+    header->offset = static_cast<std::uint32_t>(offset);
+    AllocationProfiler::recordAllocation(scope, size);
+    return user;
+}
+
+inline void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (void* p = allocate(size, alignment)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void deallocate(void* p) {
+    if (p == nullptr) {
+        return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+    AllocationProfiler::recordDeallocation(static_cast<int>(header->scope), header->size);
+    std::free(static_cast<char*>(p) - header->offset);
+}
+
+} // namespace allocation_profiler_detail
+
+void* operator new(std::size_t size) {
+    return allocation_profiler_detail::allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocation_profiler_detail::allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocation_profiler_detail::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocation_profiler_detail::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocation_profiler_detail::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocation_profiler_detail::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocation_profiler_detail::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocation_profiler_detail::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { allocation_profiler_detail::deallocate(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { allocation_profiler_detail::deallocate(p); }
+
+#endif // DISABLE_ALLOCATION_PROFILER
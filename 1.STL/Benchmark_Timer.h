@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Small helpers shared by the *_Benchmark.cpp programs
+
+// Runs fn() `repeats` times and returns the fastest run in seconds.
+// Taking the minimum filters out noise from other processes and cold caches.
+template <typename Fn>
+double measureSeconds(int repeats, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// Like measureSeconds for a sort: copies data into result before each run, outside the
+// timed part, so every repeat starts from the same input, and times sortFn(result)
+template <typename Container, typename SortFn>
+double measureSortSeconds(int repeats, const Container& data, Container& result, SortFn&& sortFn) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i) {
+        result = data;
+        auto start = std::chrono::steady_clock::now();
+        sortFn(result);
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// Keeps the optimizer from deleting a computation whose result is otherwise unused
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
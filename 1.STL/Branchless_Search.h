@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+// Branchless binary searches over random-access ranges
+//
+// std::lower_bound branches on every comparison, and on random queries half of those
+// branches are mispredicted. These versions always halve the range and pick the next
+// base with a conditional move, so the loop runs exactly log2(n) iterations with no
+// data-dependent branches.
+
+// First position whose element is not less than value (same result as std::lower_bound)
+template <typename RandomIt, typename T, typename Compare>
+RandomIt branchlessLowerBound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    auto length = std::distance(first, last);
+    if (length == 0) {
+        return first;
+    }
+    RandomIt base = first;
+    while (length > 1) {
+        auto half = length / 2;
+        base = comp(base[half], value) ? base + half : base;
+        length -= half;
+    }
+    return base + (comp(*base, value) ? 1 : 0);
+}
+
+// First position whose element is greater than value (same result as std::upper_bound)
+template <typename RandomIt, typename T, typename Compare>
+RandomIt branchlessUpperBound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    auto length = std::distance(first, last);
+    if (length == 0) {
+        return first;
+    }
+    RandomIt base = first;
+    while (length > 1) {
+        auto half = length / 2;
+        base = comp(value, base[half]) ? base : base + half;
+        length -= half;
+    }
+    return base + (comp(value, *base) ? 0 : 1);
+}
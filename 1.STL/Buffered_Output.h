@@ -0,0 +1,130 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+// BufferedOutput: fast text output of ints and strings to a std::ostream
+//
+// `std::cout << num << " "` runs the stream sentry, the locale's number formatting and a
+// virtual call for every value, and std::endl flushes the stream on top of that. When whole
+// vectors are dumped, this overhead is most of the run time. BufferedOutput formats ints with
+// std::to_chars straight into a 64 KB buffer and hands that buffer to the stream in one call
+// when it is full:
+//     BufferedOutput& out = standardOutput();     // shared buffer in front of std::cout
+//     for (int num : vec) {
+//         out << num << ' ';
+//     }
+//     out.endLine();                              // '\n', then drain()
+//
+// drain() passes the buffered text on to the stream without flushing it; flush() also flushes
+// the stream, and is the only call that does. The destructor drains. Text written directly to
+// the stream while BufferedOutput still holds some would come out of order, so code that
+// mixes the two calls endLine() or drain() first.
+//
+// The buffer is part of the object (no heap allocation), so keep instances static or on the
+// heap rather than on a small stack. Not thread-safe.
+class BufferedOutput {
+public:
+    static constexpr std::size_t kCapacity = 1 << 16;
+
+    explicit BufferedOutput(std::ostream& stream) : stream(stream) {}
+
+    ~BufferedOutput() {
+        drain();
+    }
+
+    BufferedOutput(const BufferedOutput&) = delete;
+    BufferedOutput& operator=(const BufferedOutput&) = delete;
+
+    BufferedOutput& operator<<(std::string_view text) {
+        write(text.data(), text.size());
+        return *this;
+    }
+
+    BufferedOutput& operator<<(const char* text) {
+        write(text, std::strlen(text));
+        return *this;
+    }
+
+    BufferedOutput& operator<<(char c) {
+        if (used == kCapacity) {
+            drain();
+        }
+        buffer[used++] = c;
+        return *this;
+    }
+
+    // Integers of any width, signed or not (char is text, see above; bool is not accepted)
+    template <typename Int, typename = std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, char> &&
+                                                         !std::is_same_v<Int, bool>>>
+    BufferedOutput& operator<<(Int value) {
+        // 20 digits and a sign cover every 64-bit value
+        if (kCapacity - used < 24) {
+            drain();
+        }
+        used = static_cast<std::size_t>(std::to_chars(buffer + used, buffer + kCapacity, value).ptr - buffer);
+        return *this;
+    }
+
+    // Appends size bytes; text longer than the buffer goes to the stream directly
+    void write(const char* text, std::size_t size) {
+        if (size > kCapacity - used) {
+            drain();
+            if (size >= kCapacity) {
+                stream.rdbuf()->sputn(text, static_cast<std::streamsize>(size));
+                return;
+            }
+        }
+        std::memcpy(buffer + used, text, size);
+        used += size;
+    }
+
+    // Ends the line and drains: std::endl without the flush
+    void endLine() {
+        *this << '\n';
+        drain();
+    }
+
+    // Hands the buffered text to the stream, without flushing the stream
+    void drain() {
+        if (used > 0) {
+            stream.rdbuf()->sputn(buffer, static_cast<std::streamsize>(used));
+            used = 0;
+        }
+    }
+
+    // Hands the buffered text to the stream and flushes the stream
+    void flush() {
+        drain();
+        stream.flush();
+    }
+
+    // Bytes waiting in the buffer
+    std::size_t pending() const {
+        return used;
+    }
+
+private:
+    std::ostream& stream;
+    std::size_t used = 0;
+    char buffer[kCapacity];
+};
+
+// Shared BufferedOutput in front of std::cout, created on first use
+inline BufferedOutput& standardOutput() {
+    static BufferedOutput out(std::cout);
+    return out;
+}
+
+// Writes the elements of range separated by separator, followed by a newline, then drains
+template <typename Range>
+void writeLine(BufferedOutput& out, const Range& range, char separator = ' ') {
+    for (const auto& element : range) {
+        out << element << separator;
+    }
+    out.endLine();
+}
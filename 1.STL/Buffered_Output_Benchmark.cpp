@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Buffered_Output.h"
+
+// Output throughput of a large vector of random ints, written as the print loops of
+// Algorithms.cpp, Collections.cpp and Lambda.cpp do it, in MB/s of text produced:
+//
+//   ostream << n << " "     one value at a time into the stream, std::endl at the end
+//   ostream << n << endl    one value per line, with a flush per line
+//   BufferedOutput          std::to_chars into a 64 KB buffer, one write per full buffer
+//
+// Each variant writes to the same file; the files must be byte-for-byte identical.
+//
+// Usage: Buffered_Output_Benchmark [elements] [file]   (defaults: 10000000, buffered_output.txt)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = argc > 2 ? argv[2] : "buffered_output.txt";
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(-1000000000, 1000000000);
+    std::vector<int> data(elements);
+    for (int& value : data) {
+        value = dis(gen);
+    }
+
+    // Space-separated values on one line
+    double streamTime = measureSeconds(1, [&] {
+        std::ofstream file(path, std::ios::binary);
+        for (int num : data) {
+            file << num << " ";
+        }
+        file << std::endl;
+    });
+    std::string streamText = readFile(path);
+
+    double bufferedTime = measureSeconds(1, [&] {
+        std::ofstream file(path, std::ios::binary);
+        auto out = std::make_unique<BufferedOutput>(file);
+        for (int num : data) {
+            *out << num << ' ';
+        }
+        out->endLine();
+        out->flush();
+    });
+    bool ok = readFile(path) == streamText;
+
+    // One value per line
+    double endlTime = measureSeconds(1, [&] {
+        std::ofstream file(path, std::ios::binary);
+        for (int num : data) {
+            file << num << std::endl;
+        }
+    });
+    std::string endlText = readFile(path);
+
+    double bufferedLinesTime = measureSeconds(1, [&] {
+        std::ofstream file(path, std::ios::binary);
+        auto out = std::make_unique<BufferedOutput>(file);
+        for (int num : data) {
+            *out << num << '\n';
+        }
+        out->flush();
+    });
+    ok = ok && readFile(path) == endlText;
+    std::remove(path.c_str());
+
+    auto megabytesPerSecond = [](std::size_t bytes, double seconds) { return static_cast<double>(bytes) / seconds / 1e6; };
+    std::cout << "Elements: " << elements << ", text size: " << streamText.size() / 1000000.0 << " MB" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "ostream << n << \" \":    " << std::setw(8) << megabytesPerSecond(streamText.size(), streamTime)
+              << " MB/s" << std::endl;
+    std::cout << "BufferedOutput:         " << std::setw(8) << megabytesPerSecond(streamText.size(), bufferedTime)
+              << " MB/s" << std::endl;
+    std::cout << "ostream << n << endl:   " << std::setw(8) << megabytesPerSecond(endlText.size(), endlTime)
+              << " MB/s" << std::endl;
+    std::cout << "BufferedOutput, lines:  " << std::setw(8) << megabytesPerSecond(endlText.size(), bufferedLinesTime)
+              << " MB/s" << std::endl;
+
+    if (!ok) {
+        std::cout << "BufferedOutput wrote different text!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
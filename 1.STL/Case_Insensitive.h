@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+
+#include "Simd_Kernels.h"
+#include "String_Search.h"
+
+// ASCII case-insensitive comparison, search and hashing over std::string_view
+//
+//     caseInsensitiveEqual(title, "EXISTING MOVIE")             // like gmock's StrCaseEq
+//     caseInsensitiveCompare(a, b) < 0                          // like strcasecmp(a, b) < 0
+//     caseInsensitiveFind(log, "Timeout")                       // position or npos
+//     FlatHashMap<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> counts;
+//
+// Only the ASCII letters A-Z are folded (to a-z); every other byte, including all bytes of
+// multi-byte UTF-8 sequences, must match exactly. The vector kernels fold 16 (SSE2) or 32
+// (AVX2) bytes per step: a byte is an upper-case letter if it lies between 'A' and 'Z' as a
+// signed value, and bytes from 0x80 up are negative, so they are never changed. The
+// instruction set is picked once at runtime, as for the kernels in Simd_Kernels.h.
+//
+// The ordering is that of the folded bytes as unsigned values, as with strcasecmp in the
+// C locale: "apple" < "Banana" < "cherry", and a prefix sorts before the longer string.
+
+inline char asciiToLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// Signatures shared by the kernels of every level:
+//  - mismatch: index of the first position where a and b differ after folding, or n
+//  - find: position of needle in haystack ignoring case, or npos; needle is at least 2
+//    bytes and no longer than haystack
+struct CaseFoldKernels {
+    std::size_t (*mismatch)(const char* a, const char* b, std::size_t n);
+    std::size_t (*find)(const char* haystack, std::size_t n, const char* needle, std::size_t m);
+};
+
+inline std::size_t scalarCaseMismatch(const char* a, const char* b, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (asciiToLower(a[i]) != asciiToLower(b[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+inline std::size_t scalarCaseFind(const char* haystack, std::size_t n, const char* needle, std::size_t m) {
+    const char first = asciiToLower(needle[0]);
+    for (std::size_t i = 0; i + m <= n; ++i) {
+        if (asciiToLower(haystack[i]) == first && scalarCaseMismatch(haystack + i + 1, needle + 1, m - 1) == m - 1) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// Lower-cases the ASCII letters of 16 bytes and leaves everything else alone
+inline __m128i sse2ToLower(__m128i x) {
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(x, _mm_set1_epi8('Z' + 1)));
+    return _mm_add_epi8(x, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+
+// Bit per byte of x and y (the low 8 of them if half) that differs after folding
+inline unsigned sse2CaseDiffer(__m128i x, __m128i y, bool half = false) {
+    unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(sse2ToLower(x), sse2ToLower(y))));
+    return ~equal & (half ? 0xffu : 0xffffu);
+}
+
+// The last partial block is handled by loading the final 16 (or 8) bytes again, overlapping
+// bytes already known to be equal, so short keys never fall back to the byte loop
+inline std::size_t sse2CaseMismatch(const char* a, const char* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        unsigned differ = sse2CaseDiffer(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (differ != 0) {
+            return i + lowestSetBit(differ);
+        }
+    }
+    if (i == n) {
+        return n;
+    }
+    if (n >= 16) {
+        unsigned differ = sse2CaseDiffer(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n - 16)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n - 16)));
+        return differ != 0 ? n - 16 + lowestSetBit(differ) : n;
+    }
+    if (n >= 8) {
+        for (std::size_t at : {std::size_t(0), n - 8}) {
+            unsigned differ = sse2CaseDiffer(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + at)),
+                                             _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + at)), true);
+            if (differ != 0) {
+                return at + lowestSetBit(differ);
+            }
+        }
+        return n;
+    }
+    return scalarCaseMismatch(a, b, n);
+}
+
+// A candidate of the first-and-last-byte filter whose folded middle bytes match
+inline bool sse2CaseMiddleMatches(const char* candidate, const char* needle, std::size_t m) {
+    return sse2CaseMismatch(candidate + 1, needle + 1, m - 2) == m - 2;
+}
+
+// The first-and-last-byte filter of String_Search.h on folded bytes
+inline std::size_t sse2CaseFind(const char* haystack, std::size_t n, const char* needle, std::size_t m) {
+    return sse2FirstLastFind<sse2ToLower, sse2CaseMiddleMatches, scalarCaseFind>(haystack, n, needle, m);
+}
+
+SIMD_TARGET_AVX2 inline __m256i avx2ToLower(__m256i x) {
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('A' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), x));
+    return _mm256_add_epi8(x, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2CaseMismatch(const char* a, const char* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = avx2ToLower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        __m256i y = avx2ToLower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        unsigned differ = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (differ != 0) {
+            return i + lowestSetBit(differ);
+        }
+    }
+    return i + sse2CaseMismatch(a + i, b + i, n - i);
+}
+
+SIMD_TARGET_AVX2 inline bool avx2CaseMiddleMatches(const char* candidate, const char* needle, std::size_t m) {
+    return avx2CaseMismatch(candidate + 1, needle + 1, m - 2) == m - 2;
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2CaseFind(const char* haystack, std::size_t n, const char* needle,
+                                                 std::size_t m) {
+    return avx2FirstLastFind<avx2ToLower, avx2CaseMiddleMatches, sse2CaseFind>(haystack, n, needle, m);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Case-folding kernels of a level
+inline const CaseFoldKernels& caseFoldKernels(SimdLevel level) {
+    static const CaseFoldKernels scalar = {scalarCaseMismatch, scalarCaseFind};
+#ifdef SIMD_KERNELS_X86
+    static const CaseFoldKernels sse2 = {sse2CaseMismatch, sse2CaseFind};
+    static const CaseFoldKernels avx2 = {avx2CaseMismatch, avx2CaseFind};
+    return kernelsForLevel(level, scalar, sse2, avx2);
+#else
+    return kernelsForLevel(level, scalar);
+#endif
+}
+
+inline const CaseFoldKernels& caseFoldKernels() {
+    static const CaseFoldKernels& kernels = caseFoldKernels(simdLevel());
+    return kernels;
+}
+
+inline bool caseInsensitiveEqual(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && caseFoldKernels().mismatch(a.data(), b.data(), a.size()) == a.size();
+}
+
+// Negative, zero or positive as a sorts before, with or after b ignoring case
+inline int caseInsensitiveCompare(std::string_view a, std::string_view b) {
+    const std::size_t common = a.size() < b.size() ? a.size() : b.size();
+    const std::size_t i = caseFoldKernels().mismatch(a.data(), b.data(), common);
+    if (i < common) {
+        return static_cast<unsigned char>(asciiToLower(a[i])) - static_cast<unsigned char>(asciiToLower(b[i]));
+    }
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+// Position of the first occurrence of needle in haystack at or after pos ignoring case, or npos
+inline std::size_t caseInsensitiveFind(std::string_view haystack, std::string_view needle, std::size_t pos = 0) {
+    if (pos > haystack.size() || needle.size() > haystack.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (needle.empty()) {
+        return pos;
+    }
+    // The vector kernels need a first and a last byte that differ in position
+    const auto find = needle.size() == 1 ? scalarCaseFind : caseFoldKernels().find;
+    const std::size_t found = find(haystack.data() + pos, haystack.size() - pos, needle.data(), needle.size());
+    return found == std::string_view::npos ? found : pos + found;
+}
+
+// Hash of the folded bytes: strings that are caseInsensitiveEqual hash the same.
+// Eight bytes are folded at a time inside a 64-bit word (SWAR): the high bit of each byte is
+// set in a mask where the byte lies between 'A' and 'Z', bytes from 0x80 up are masked out,
+// and the mask shifted down to 0x20 is ORed in.
+inline std::size_t caseInsensitiveHash(std::string_view text) {
+    constexpr std::uint64_t kOnes = 0x0101010101010101ull;
+    constexpr std::uint64_t kHigh = 0x8080808080808080ull;
+    constexpr std::uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+    auto fold = [&](std::uint64_t word) {
+        const std::uint64_t low7 = word & ~kHigh;
+        const std::uint64_t atLeastA = low7 + kOnes * (0x80 - 'A');
+        const std::uint64_t aboveZ = low7 + kOnes * (0x80 - 'Z' - 1);
+        const std::uint64_t upper = (atLeastA ^ aboveZ) & ~word & kHigh;
+        return word | (upper >> 2);
+    };
+    auto mix = [&](std::uint64_t h, std::uint64_t word) {
+        h = (h ^ word) * kMultiplier;
+        return h ^ (h >> 32);
+    };
+    std::uint64_t h = text.size() * kMultiplier;
+    std::size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, text.data() + i, 8);
+        h = mix(h, fold(word));
+    }
+    if (i < text.size()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + i, text.size() - i);
+        h = mix(h, fold(word));
+    }
+    return static_cast<std::size_t>(h);
+}
+
+// Function objects for containers; all accept any string-like key without converting it
+struct CaseInsensitiveHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const {
+        return caseInsensitiveHash(text);
+    }
+};
+
+struct CaseInsensitiveEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return caseInsensitiveEqual(a, b);
+    }
+};
+
+struct CaseInsensitiveLess {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return caseInsensitiveCompare(a, b) < 0;
+    }
+};
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Case_Insensitive.h"
+#include "Flat_Hash_Map.h"
+
+// Compares byte-at-a-time case folding (std::tolower on every byte) with the kernels of
+// Case_Insensitive.h at every SIMD level this machine supports:
+//   - equality and ordering of short keys (8 to 24 bytes, like "EXISTING MOVIE")
+//   - equality of long strings (4 KB)
+//   - searching a needle near the end of a 16 MB text
+//   - counting mixed-case keys in a FlatHashMap keyed with CaseInsensitiveHash against
+//     lower-casing a copy of every key for a std::unordered_map
+// Every method must give the same answers; any difference is reported and makes the
+// program exit with status 1. Some keys contain UTF-8 bytes, which must not be folded.
+//
+// Usage: Case_Insensitive_Benchmark [pairs]
+//        (default: 1000000 short key pairs)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+namespace {
+
+bool toLowerEqual(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+int toLowerCompare(std::string_view a, std::string_view b) {
+    for (std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        int x = std::tolower(static_cast<unsigned char>(a[i]));
+        int y = std::tolower(static_cast<unsigned char>(b[i]));
+        if (x != y) {
+            return x - y;
+        }
+    }
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+std::string randomKey(std::mt19937& gen, std::size_t length) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ_-0123456789";
+    std::uniform_int_distribution<std::size_t> pick(0, sizeof(alphabet) - 2);
+    std::string key;
+    for (std::size_t i = 0; i < length; ++i) {
+        key.push_back(alphabet[pick(gen)]);
+    }
+    if (gen() % 8 == 0) {
+        key.replace(0, std::min<std::size_t>(2, key.size()), "\xC3\xA9"); // é
+    }
+    return key;
+}
+
+// The same key with the case of random letters swapped
+std::string flipCase(std::string key, std::mt19937& gen) {
+    for (char& c : key) {
+        if (gen() % 2 == 0 && std::isalpha(static_cast<unsigned char>(c))) {
+            c = static_cast<char>(std::isupper(static_cast<unsigned char>(c)) ? std::tolower(c) : std::toupper(c));
+        }
+    }
+    return key;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t pairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+#ifdef SIMD_KERNELS_X86
+    levels.push_back(SimdLevel::SSE2);
+    if (simdLevel() == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+#endif
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> shortLength(8, 24);
+    std::vector<std::string> left;
+    std::vector<std::string> right;
+    for (std::size_t i = 0; i < pairs; ++i) {
+        left.push_back(randomKey(gen, shortLength(gen)));
+        // Half of the pairs are equal ignoring case; the rest differ in one byte or in length
+        std::string other = flipCase(left.back(), gen);
+        if (i % 2 == 1) {
+            if (gen() % 2 == 0) {
+                other.back() = other.back() == 'x' ? 'y' : 'x';
+            } else {
+                other.push_back('x');
+            }
+        }
+        right.push_back(other);
+    }
+    const std::size_t longLength = 4096;
+    const std::size_t longPairs = std::max<std::size_t>(1, pairs / 256);
+    std::vector<std::string> longLeft;
+    std::vector<std::string> longRight;
+    for (std::size_t i = 0; i < longPairs; ++i) {
+        longLeft.push_back(randomKey(gen, longLength));
+        longRight.push_back(flipCase(longLeft.back(), gen));
+    }
+
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(2);
+
+    // Short keys: equality and ordering
+    std::size_t expectedEqual = 0;
+    long expectedOrder = 0;
+    double equalTime = measureSeconds(3, [&] {
+        expectedEqual = 0;
+        for (std::size_t i = 0; i < pairs; ++i) {
+            expectedEqual += toLowerEqual(left[i], right[i]);
+        }
+    });
+    double compareTime = measureSeconds(3, [&] {
+        expectedOrder = 0;
+        for (std::size_t i = 0; i < pairs; ++i) {
+            expectedOrder += sign(toLowerCompare(left[i], right[i])) * static_cast<long>(i % 7 + 1);
+        }
+    });
+    std::cout << "Short keys (" << pairs << " pairs), ns per pair: tolower equal " << equalTime / pairs * 1e9
+              << ", compare " << compareTime / pairs * 1e9 << std::endl;
+    for (SimdLevel level : levels) {
+        const CaseFoldKernels& kernels = caseFoldKernels(level);
+        std::size_t equal = 0;
+        long order = 0;
+        double levelEqualTime = measureSeconds(3, [&] {
+            equal = 0;
+            for (std::size_t i = 0; i < pairs; ++i) {
+                const std::string& a = left[i];
+                const std::string& b = right[i];
+                equal += a.size() == b.size() && kernels.mismatch(a.data(), b.data(), a.size()) == a.size();
+            }
+        });
+        double levelCompareTime = measureSeconds(3, [&] {
+            order = 0;
+            for (std::size_t i = 0; i < pairs; ++i) {
+                const std::string& a = left[i];
+                const std::string& b = right[i];
+                const std::size_t common = std::min(a.size(), b.size());
+                const std::size_t at = kernels.mismatch(a.data(), b.data(), common);
+                int result = at < common ? static_cast<unsigned char>(asciiToLower(a[at])) - static_cast<unsigned char>(asciiToLower(b[at]))
+                                         : a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+                order += sign(result) * static_cast<long>(i % 7 + 1);
+            }
+        });
+        ok = ok && equal == expectedEqual && order == expectedOrder;
+        std::cout << "  " << std::setw(6) << simdLevelName(level) << ": equal " << std::setw(6)
+                  << levelEqualTime / pairs * 1e9 << ", compare " << std::setw(6) << levelCompareTime / pairs * 1e9
+                  << std::endl;
+    }
+
+    // Long strings: equality throughput
+    const double longGigabytes = static_cast<double>(longPairs * longLength) / 1e9;
+    std::size_t longEqual = 0;
+    double longTime = measureSeconds(3, [&] {
+        longEqual = 0;
+        for (std::size_t i = 0; i < longPairs; ++i) {
+            longEqual += toLowerEqual(longLeft[i], longRight[i]);
+        }
+    });
+    ok = ok && longEqual == longPairs;
+    std::cout << "Long strings (" << longLength << " bytes), GB/s: tolower equal " << longGigabytes / longTime;
+    for (SimdLevel level : levels) {
+        const CaseFoldKernels& kernels = caseFoldKernels(level);
+        std::size_t equal = 0;
+        double time = measureSeconds(3, [&] {
+            equal = 0;
+            for (std::size_t i = 0; i < longPairs; ++i) {
+                equal += kernels.mismatch(longLeft[i].data(), longRight[i].data(), longLength) == longLength;
+            }
+        });
+        ok = ok && equal == longPairs;
+        std::cout << ", " << simdLevelName(level) << " " << longGigabytes / time;
+    }
+    std::cout << std::endl;
+
+    // Search
+    std::string text = randomKey(gen, 16 << 20);
+    const std::string needle = "Connection Reset By Peer";
+    text.replace(text.size() - 100, needle.size(), flipCase(needle, gen));
+    const std::size_t expectedPosition = text.size() - 100;
+    std::size_t position = 0;
+    double searchTime = measureSeconds(3, [&] {
+        position = static_cast<std::size_t>(
+            std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                        [](char x, char y) {
+                            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+                        }) - text.begin());
+    });
+    ok = ok && position == expectedPosition;
+    const double textGigabytes = static_cast<double>(text.size()) / 1e9;
+    std::cout << "Search in " << (text.size() >> 20) << " MB, GB/s: std::search with tolower " << textGigabytes / searchTime;
+    for (SimdLevel level : levels) {
+        const CaseFoldKernels& kernels = caseFoldKernels(level);
+        double time = measureSeconds(3, [&] { position = kernels.find(text.data(), text.size(), needle.data(), needle.size()); });
+        ok = ok && position == expectedPosition;
+        std::cout << ", " << simdLevelName(level) << " " << textGigabytes / time;
+    }
+    std::cout << std::endl;
+
+    // Hash map keyed case-insensitively
+    const std::size_t keyCount = std::max<std::size_t>(1, pairs / 10);
+    FlatHashMap<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> flatCounts;
+    std::unordered_map<std::string, int> lowerCounts;
+    for (std::size_t i = 0; i < keyCount; ++i) {
+        std::string lower = left[i];
+        std::transform(lower.begin(), lower.end(), lower.begin(), asciiToLower);
+        flatCounts[left[i]] = 0;
+        lowerCounts[lower] = 0;
+    }
+    double lowerTime = measureSeconds(1, [&] {
+        for (const std::string& key : right) {
+            std::string lower = key;
+            std::transform(lower.begin(), lower.end(), lower.begin(), asciiToLower);
+            auto it = lowerCounts.find(lower);
+            if (it != lowerCounts.end()) {
+                ++it->second;
+            }
+        }
+    });
+    double flatTime = measureSeconds(1, [&] {
+        for (const std::string& key : right) {
+            auto it = flatCounts.find(std::string_view(key));
+            if (it != flatCounts.end()) {
+                ++it->second;
+            }
+        }
+    });
+    for (const auto& [key, count] : flatCounts) {
+        std::string lower = key;
+        std::transform(lower.begin(), lower.end(), lower.begin(), asciiToLower);
+        ok = ok && lowerCounts[lower] == count;
+    }
+    std::cout << "Hash lookups of " << right.size() << " mixed-case keys, ns per lookup: lower-cased copy + "
+              << "std::unordered_map " << lowerTime / right.size() * 1e9 << ", FlatHashMap with CaseInsensitiveHash "
+              << flatTime / right.size() * 1e9 << std::endl;
+
+    std::cout << (ok ? "All methods agree." : "Results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -1,43 +1,29 @@
+#include <cstdio>
 #include <iostream>
 #include <vector>
 #include <map>
 #include <list>
+#include <memory_resource>
 #include <queue>
 #include <set>
-
-// A simple class representing a person
-class Person {
-public:
-    Person(const std::string& name, int age) : name(name), age(age) {}
-
-    // Getters and setters
-    std::string getName() const {
-        return name;
-    }
-
-    void setName(const std::string& name) {
-        this->name = name;
-    }
-
-    int getAge() const {
-        return age;
-    }
-
-    void setAge(int age) {
-        this->age = age;
-    }
-
-    // Overloaded comparison operators for sorting
-    bool operator<(const Person& other) const {
-        return age < other.age;
-    }
-
-private:
-    std::string name;
-    int age;
-};
+#include <string_view>
+
+#include "Person.h"
+#include "Allocation_Profiler.h"
+#include "Buffered_Output.h" // The element lists below go through one shared output buffer
+#include "Flat_Hash_Map.h"
+#include "Flat_Multimap.h"
+#include "Flat_Set.h"
+#include "Mpmc_Queue.h"
+#include "Node_Pool.h"
+#include "Person_Index.h"
+#include "Person_Output.h"
+#include "Person_Snapshot.h"
+#include "Person_Table.h"
 
 int vectorExamples() {
+    AllocationScope scope("vectorExamples");
+
     // Vector: A dynamic array that can grow and shrink in size
     // #include <vector>
 
@@ -55,19 +41,21 @@ int vectorExamples() {
     numbers[0] = 10;
     numbers[1] = 20;
 
+    BufferedOutput& out = standardOutput();
+
     // Iterate using iterators
-    std::cout << "Vector elements using iterators: ";
+    out << "Vector elements using iterators: ";
     for (auto it = numbers.begin(); it != numbers.end(); ++it) { // auto is a placeholder for the type of the iterator
-        std::cout << *it << " ";
+        out << *it << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Iterate using reverse iterators
-    std::cout << "Vector elements in reverse: ";
+    out << "Vector elements in reverse: ";
     for (auto rit = numbers.rbegin(); rit != numbers.rend(); ++rit) { // auto does not mean that the type is unknown, it means that the type is deduced from the initializer
-        std::cout << *rit << " ";
+        out << *rit << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Create a vector of Person objects
     std::vector<Person> people;
@@ -93,11 +81,9 @@ int vectorExamples() {
     people.emplace_back("Eve", 40);
 
     // Display the elements of the vector
-    std::cout << "People vector elements: ";
-    for (const Person& person : people) {
-        std::cout << person.getName() << " (" << person.getAge() << ") ";
-    }
-    std::cout << std::endl;
+    out << "People vector elements: ";
+    writePeople(out, people);
+    out.endLine();
 
     // Check if the vector is empty
     if (people.empty()) {
@@ -110,11 +96,17 @@ int vectorExamples() {
     std::cout << "The size of the people vector is: " << people.size() << std::endl;
 
     // Reserve space for elements
-    people.reserve(10);
+    {
+        AllocationScope section("vectorExamples: reserve(10)");
+        people.reserve(10);
+    }
     std::cout << "The capacity of the people vector after reserving space is: " << people.capacity() << std::endl;
 
     // Shrink the capacity to fit the size
-    people.shrink_to_fit();
+    {
+        AllocationScope section("vectorExamples: shrink_to_fit");
+        people.shrink_to_fit();
+    }
     std::cout << "The capacity of the people vector after shrinking to fit is: " << people.capacity() << std::endl;
 
     // Accessing elements using at() method
@@ -152,12 +144,14 @@ int vectorExamples() {
     std::cout << "OtherPeople vector size: " << otherPeople.size() << std::endl;
 
     // Using the assign() method to assign new contents to the vector
-    people.assign(3, Person("Hank", 60));
-    std::cout << "People vector after assign: ";
-    for (const Person& person : people) {
-        std::cout << person.getName() << " (" << person.getAge() << ") ";
-    }
-    std::cout << std::endl;
+    // An interned name is stored once in the global NamePool, so the three copies share it
+    {
+        AllocationScope section("vectorExamples: assign(3, ...)");
+        people.assign(3, Person(internName("Hank"), 60));
+    }
+    out << "People vector after assign: ";
+    writePeople(out, people);
+    out.endLine();
     
     // Clear all elements from the vector
     people.clear();
@@ -165,7 +159,76 @@ int vectorExamples() {
     return 0;
 };
 
+int personTableExamples() {
+    AllocationScope scope("personTableExamples");
+
+    // PersonTable: A columnar (structure-of-arrays) alternative to std::vector<Person>
+    // #include "Person_Table.h"
+
+    // Names and ages are kept in two separate arrays, so scans over ages
+    // do not have to drag every name through the cache
+
+    // Create a table of people
+    PersonTable people;
+
+    // Add some people to the table
+    people.push_back(Person("Alice", 30));
+    people.push_back(Person("Bob", 25));
+    people.push_back(Person("Charlie", 35));
+    people.push_back(Person("Jane", 22));
+
+    // Remove the last row
+    people.pop_back();
+
+    // Insert a row at a specific position
+    people.insert(people.begin() + 1, Person("Dave", 28));
+
+    // Erase a row at a specific position
+    people.erase(people.begin() + 2);
+
+    // Use the emplace_back method to construct a row in place
+    people.emplace_back("Eve", 40);
+
+    BufferedOutput& out = standardOutput();
+
+    // Display the rows of the table (each row has the same getters as Person)
+    out << "PersonTable rows: ";
+    writePeople(out, people);
+    out.endLine();
+
+    // Column scans only read the age column
+    std::cout << "People aged 26 to 40: " << people.countAgesBetween(26, 40) << std::endl;
+    std::cout << "Average age: " << people.averageAge() << std::endl;
+    std::cout << "Youngest: " << people.minAge() << ", oldest: " << people.maxAge() << std::endl;
+
+    out << "Rows with age 30 or more: ";
+    for (std::size_t row : people.filterAgesBetween(30, 200)) {
+        out << people[row].getName() << " ";
+    }
+    out.endLine();
+
+    // Using the swap() method to swap contents of two tables
+    PersonTable otherPeople;
+    otherPeople.push_back(Person("Frank", 50));
+    otherPeople.push_back(Person("Grace", 45));
+    people.swap(otherPeople);
+    std::cout << "People table size after swap: " << people.size() << std::endl;
+
+    // Using the assign() method to assign new contents to the table
+    people.assign(3, Person("Hank", 60));
+    out << "People table after assign: ";
+    writePeople(out, people);
+    out.endLine();
+
+    // Clear all rows from the table
+    people.clear();
+
+    return 0;
+};
+
 int mapExamples() {
+    AllocationScope scope("mapExamples");
+
     // Map: An associative container that stores key-value pairs
     // #include <map>
 
@@ -177,18 +240,21 @@ int mapExamples() {
     ageMap["Bob"] = 25;
     ageMap["Charlie"] = 35;
 
+    BufferedOutput& out = standardOutput();
+
     // Display the elements of the map
-    std::cout << "Map elements: ";
+    out << "Map elements: ";
     for (const auto& pair : ageMap) {
-        std::cout << pair.first << " (" << pair.second << ") ";
+        out << pair.first << " (" << pair.second << ") ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Iterate using iterators
-    std::cout << "Map elements using iterators: ";
+    out << "Map elements using iterators: ";
     for (auto it = ageMap.begin(); it != ageMap.end(); ++it) {
-        std::cout << it->first << " (" << it->second << ") ";
+        out << it->first << " (" << it->second << ") ";
     }
+    out.drain();
 
     // Access and modify elements
     ageMap["Alice"] = 31;
@@ -210,10 +276,13 @@ int mapExamples() {
     ageMap.erase("Charlie");
 
     // Insert an element
-    ageMap.insert(std::make_pair("Dave", 28));
+    {
+        AllocationScope section("mapExamples: insert/emplace");
+        ageMap.insert(std::make_pair("Dave", 28));
 
-    // Use the emplace method to construct elements in place
-    ageMap.emplace("Eve", 40);
+        // Use the emplace method to construct elements in place
+        ageMap.emplace("Eve", 40);
+    }
 
     // Check if the map is empty
     if (ageMap.empty()) {
@@ -231,7 +300,65 @@ int mapExamples() {
     return 0;
 };
 
+int flatHashMapExamples() {
+    AllocationScope scope("flatHashMapExamples");
+
+    // FlatHashMap: An open-addressing hash map stored in one contiguous array
+    // #include "Flat_Hash_Map.h"
+
+    // Lookups with string literals or std::string_view do not build a temporary std::string
+    // Iteration order is unspecified, unlike the sorted order of std::map
+
+    // Create a hash map of string to int
+    FlatHashMap<std::string, int> ageMap;
+
+    // Add some elements to the map
+    ageMap["Alice"] = 30;
+    ageMap["Bob"] = 25;
+    ageMap["Charlie"] = 35;
+
+    BufferedOutput& out = standardOutput();
+
+    // Display the elements of the map
+    out << "FlatHashMap elements: ";
+    for (const auto& pair : ageMap) {
+        out << pair.first << " (" << pair.second << ") ";
+    }
+    out.endLine();
+
+    // Access and modify elements
+    ageMap["Alice"] = 31;
+    ageMap["Bob"] = 26;
+
+    // Look up a key through a std::string_view without allocating
+    std::string_view key = "Charlie";
+    auto found = ageMap.find(key);
+    if (found != ageMap.end()) {
+        std::cout << "Charlie's age is: " << found->second << std::endl;
+    }
+
+    // Remove an element by key
+    ageMap.erase("Charlie");
+    std::cout << "Charlie is " << (ageMap.contains("Charlie") ? "" : "no longer ") << "in the map." << std::endl;
+
+    // Insert an element
+    ageMap.insert(std::make_pair("Dave", 28));
+
+    // Use the emplace method to construct elements in place
+    ageMap.emplace("Eve", 40);
+
+    // Get the size of the map
+    std::cout << "The size of the FlatHashMap is: " << ageMap.size() << std::endl;
+
+    // Clear all elements from the map
+    ageMap.clear();
+
+    return 0;
+};
+
 int listExamples() {
+    AllocationScope scope("listExamples");
+
     // List: A doubly linked list that allows fast insertion and deletion of elements
     // #include <list>
 
@@ -248,12 +375,14 @@ int listExamples() {
     numberList.push_back(4);
     numberList.push_back(5);
 
+    BufferedOutput& out = standardOutput();
+
     // Display the elements of the list
-    std::cout << "List elements: ";
+    out << "List elements: ";
     for (int number : numberList) {
-        std::cout << number << " ";
+        out << number << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Access and modify elements
     auto it = numberList.begin();
@@ -261,18 +390,18 @@ int listExamples() {
     *it = 20;
 
     // Iterate using iterators
-    std::cout << "List elements using iterators: ";
+    out << "List elements using iterators: ";
     for (auto it = numberList.begin(); it != numberList.end(); ++it) {
-        std::cout << *it << " ";
+        out << *it << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Iterate using reverse iterators
-    std::cout << "List elements in reverse: ";
+    out << "List elements in reverse: ";
     for (auto rit = numberList.rbegin(); rit != numberList.rend(); ++rit) {
-        std::cout << *rit << " ";
+        out << *rit << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Create a list of Person objects
     std::list<Person> personList;
@@ -283,11 +412,9 @@ int listExamples() {
     personList.push_back(Person("Charlie", 35));
 
     // Display the elements of the list
-    std::cout << "Person list elements: ";
-    for (const Person& person : personList) {
-        std::cout << person.getName() << " (" << person.getAge() << ") ";
-    }
-    std::cout << std::endl;
+    out << "Person list elements: ";
+    writePeople(out, personList);
+    out.endLine();
 
     // Remove the last element
     personList.pop_back();
@@ -317,11 +444,39 @@ int listExamples() {
 
     // Clear all elements from the list
     personList.clear();
-    
+
+    // Lists can take their nodes from a memory pool instead of one malloc per node
+    // #include <memory_resource> and "Node_Pool.h"
+    NodePool pool;
+    std::pmr::list<Person> pooledList(&pool);
+
+    pooledList.push_back(Person("Alice", 30));
+    pooledList.push_back(Person("Bob", 25));
+    pooledList.push_back(Person("Charlie", 35));
+
+    // Nodes released by pop_back and erase go back to the pool...
+    pooledList.pop_back();
+    pooledList.erase(pooledList.begin());
+
+    // ...and are reused by the next insertions
+    pooledList.emplace_back("Dave", 28);
+    pooledList.emplace_front("Eve", 40);
+
+    out << "Pooled person list elements: ";
+    writePeople(out, pooledList);
+    out.endLine();
+    std::cout << "Pool nodes in use: " << pool.blocksInUse() << ", nodes recycled: " << pool.blocksRecycled() << std::endl;
+
+    // The same pool can serve lists of other types
+    std::pmr::list<int> pooledNumbers({1, 2, 3, 4, 5}, &pool);
+    std::cout << "Pooled number list size: " << pooledNumbers.size() << std::endl;
+
     return 0;
 };
 
 int queueExamples() {
+    AllocationScope scope("queueExamples");
+
     // Queue: A FIFO (First-In-First-Out) data structure
     // #include <queue>
 
@@ -335,13 +490,15 @@ int queueExamples() {
     numberQueue.push(4);
     numberQueue.push(5);
 
+    BufferedOutput& out = standardOutput();
+
     // Display the elements of the queue
-    std::cout << "Queue elements: ";
+    out << "Queue elements: ";
     while (!numberQueue.empty()) {
-        std::cout << numberQueue.front() << " ";
+        out << numberQueue.front() << " ";
         numberQueue.pop();
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Create a queue of Person objects
     std::queue<Person> personQueue;
@@ -352,18 +509,34 @@ int queueExamples() {
     personQueue.push(Person("Charlie", 35));
 
     // Display the elements of the queue
-    std::cout << "Person queue elements: ";
-    while (!personQueue.empty()) {
-        const Person& person = personQueue.front();
-        std::cout << person.getName() << " (" << person.getAge() << ") ";
-        personQueue.pop();
+    out << "Person queue elements: ";
+    writeAndPopPeople(out, personQueue);
+    out.endLine();
+
+    // std::queue is not thread-safe. MpmcQueue is a fixed-size, lock-free queue that many
+    // producer and consumer threads can use at the same time
+    // #include "Mpmc_Queue.h"
+    MpmcQueue<Person> sharedQueue(8); // Capacity is fixed when the queue is created
+
+    // Construct elements in place, one at a time or as a batch
+    sharedQueue.emplace("Alice", 30);
+    sharedQueue.emplace("Bob", 25);
+    std::vector<Person> batch = {Person("Charlie", 35), Person("Dave", 28)};
+    sharedQueue.tryPushBatch(batch.begin(), batch.size());
+
+    // tryPop returns an empty std::optional once the queue is drained
+    out << "MpmcQueue elements: ";
+    while (auto person = sharedQueue.tryPop()) {
+        out << person->getName() << " (" << person->getAge() << ") ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     return 0;
 };
 
 int setExamples() {
+    AllocationScope scope("setExamples");
+
     // Set: An associative container that contains a sorted set of unique objects
     // #include <set>
 
@@ -377,22 +550,24 @@ int setExamples() {
     numberSet.insert(5);
     numberSet.insert(3);
 
+    BufferedOutput& out = standardOutput();
+
     // Display the elements of the set
-    std::cout << "Set elements: ";
+    out << "Set elements: ";
     for (int number : numberSet) {
-        std::cout << number << " ";
+        out << number << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Access and modify elements
     numberSet.erase(3); // Remove element with value 3
 
     // Iterate using iterators
-    std::cout << "Set elements using iterators: ";
+    out << "Set elements using iterators: ";
     for (auto it = numberSet.begin(); it != numberSet.end(); ++it) {
-        std::cout << *it << " ";
+        out << *it << " ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Check if an element exists
     if (numberSet.find(2) != numberSet.end()) {
@@ -402,7 +577,9 @@ int setExamples() {
     }
 
     // Create a set of Person objects
-    std::set<Person> personSet;
+    // FlatSet is a drop-in replacement for std::set that keeps the elements in a sorted vector
+    // #include "Flat_Set.h"
+    FlatSet<Person> personSet;
 
     // Add some Person objects to the set
     personSet.insert(Person("Alice", 30));
@@ -410,11 +587,9 @@ int setExamples() {
     personSet.insert(Person("Charlie", 35));
 
     // Display the elements of the set
-    std::cout << "Person set elements: ";
-    for (const Person& person : personSet) {
-        std::cout << person.getName() << " (" << person.getAge() << ") ";
-    }
-    std::cout << std::endl;
+    out << "Person set elements: ";
+    writePeople(out, personSet);
+    out.endLine();
 
     // Remove an element
     personSet.erase(Person("Alice", 30));
@@ -432,35 +607,79 @@ int setExamples() {
     // Clear all elements from the set
     personSet.clear();
 
+    // Person::operator< only compares ages, so a set of Person treats two people
+    // with the same age as duplicates and keeps only one of them
+    personSet.insert(Person("Frank", 50));
+    personSet.insert(Person("Grace", 50));
+    std::cout << "Person set size after inserting two 50 year olds: " << personSet.size() << std::endl;
+
+    // PersonIndex stores every person once, with a hash index on the name
+    // and an ordered index on the age
+    // #include "Person_Index.h"
+    PersonIndex personIndex;
+    personIndex.insert(Person("Alice", 30));
+    personIndex.insert(Person("Bob", 25));
+    personIndex.insert(Person("Charlie", 35));
+    personIndex.insert(Person("Frank", 50));
+    personIndex.insert(Person("Grace", 50));
+
+    // Iteration is ordered by age
+    out << "Person index elements: ";
+    writePeople(out, personIndex);
+    out.endLine();
+
+    // Constant-time lookup by name
+    if (const Person* bob = personIndex.findByName("Bob")) {
+        std::cout << "Bob's age is: " << bob->getAge() << std::endl;
+    }
+
+    // Updates go through the container, so both indexes stay consistent
+    personIndex.setAge("Bob", 45);
+    personIndex.setName("Charlie", "Chuck");
+
+    // Logarithmic age-range query
+    out << "People aged 35 to 50: ";
+    writePeople(out, personIndex.findByAgeRange(35, 50));
+    out.endLine();
+
     return 0;
 };
 
 int multimapExamples() {
+    AllocationScope scope("multimapExamples");
+
     // Multimap: An associative container that contains a sorted set of key-value pairs, where multiple elements can have the same key
     // #include <map>
 
     // Create a multimap of string to int
-    std::multimap<std::string, int> ageMultimap;
+    // FlatMultimap is a drop-in replacement for std::multimap that keeps the pairs in a sorted vector
+    // #include "Flat_Multimap.h"
+    FlatMultimap<std::string, int> ageMultimap;
 
     // Add some elements to the multimap
-    ageMultimap.insert(std::make_pair("Alice", 30));
-    ageMultimap.insert(std::make_pair("Bob", 25));
-    ageMultimap.insert(std::make_pair("Charlie", 35));
-    ageMultimap.insert(std::make_pair("Alice", 32)); // Alice appears twice
+    {
+        AllocationScope section("multimapExamples: make_pair inserts");
+        ageMultimap.insert(std::make_pair("Alice", 30));
+        ageMultimap.insert(std::make_pair("Bob", 25));
+        ageMultimap.insert(std::make_pair("Charlie", 35));
+        ageMultimap.insert(std::make_pair("Alice", 32)); // Alice appears twice
+    }
+
+    BufferedOutput& out = standardOutput();
 
     // Display the elements of the multimap
-    std::cout << "Multimap elements: ";
+    out << "Multimap elements: ";
     for (const auto& pair : ageMultimap) {
-        std::cout << pair.first << " (" << pair.second << ") ";
+        out << pair.first << " (" << pair.second << ") ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Iterate using iterators
-    std::cout << "Multimap elements using iterators: ";
+    out << "Multimap elements using iterators: ";
     for (auto it = ageMultimap.begin(); it != ageMultimap.end(); ++it) {
-        std::cout << it->first << " (" << it->second << ") ";
+        out << it->first << " (" << it->second << ") ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Access and modify elements
     auto range = ageMultimap.equal_range("Alice");
@@ -471,11 +690,11 @@ int multimapExamples() {
     }
 
     // Display the elements of the multimap after modification
-    std::cout << "Multimap elements after modification: ";
+    out << "Multimap elements after modification: ";
     for (const auto& pair : ageMultimap) {
-        std::cout << pair.first << " (" << pair.second << ") ";
+        out << pair.first << " (" << pair.second << ") ";
     }
-    std::cout << std::endl;
+    out.endLine();
 
     // Check if a key exists
     if (ageMultimap.find("Charlie") != ageMultimap.end()) {
@@ -509,11 +728,61 @@ int multimapExamples() {
     return 0;
 };
 
+int snapshotExamples() {
+    AllocationScope scope("snapshotExamples");
+
+    // Person snapshots: A binary file that can be memory-mapped and read without deserializing
+    // #include "Person_Snapshot.h"
+
+    // Any of the containers above can be written to a snapshot
+    std::vector<Person> people = {Person("Alice", 30), Person("Bob", 25), Person("Charlie", 35)};
+    writePersonSnapshot("people.snapshot", people);
+
+    // Maps from name to age work too
+    std::map<std::string, int> ageMap = {{"Dave", 28}, {"Eve", 40}};
+    writePersonSnapshot("ages.snapshot", ageMap);
+
+    try {
+        // Opening maps the file; records are read straight from the mapped bytes
+        PersonSnapshot snapshot("people.snapshot");
+        std::cout << "Snapshot records: ";
+        for (const auto& person : snapshot) {
+            std::cout << person.getName() << " (" << person.getAge() << ") ";
+        }
+        std::cout << std::endl;
+        std::cout << "Second record: " << snapshot.getName(1) << " (" << snapshot.getAge(1) << ")" << std::endl;
+
+        PersonSnapshot ages("ages.snapshot");
+        std::cout << "Snapshot written from a map has " << ages.size() << " records" << std::endl;
+
+        // A damaged or foreign file is rejected with an exception
+        PersonSnapshot missing("missing.snapshot");
+    } catch (const std::runtime_error& e) {
+        std::cout << "Snapshot error: " << e.what() << std::endl;
+    }
+
+    std::remove("people.snapshot");
+    std::remove("ages.snapshot");
+
+    return 0;
+};
+
 int main() {
+    // Prints how much each demo allocated when main() returns
+    AllocationReport report(std::cout);
+
+    // Intern the demo's names before any scope opens, so the NamePool's own setup is not
+    // charged to the vectorExamples: assign(3, ...) row, which should show only the buffer
+    internName("Hank");
+
     std::cout << "\nVector Examples:\n" << std::endl;
     vectorExamples();
+    std::cout << "----------------------------------------\nPersonTable Examples:\n" << std::endl;
+    personTableExamples();
     std::cout << "----------------------------------------\nMap Examples:\n" << std::endl;
     mapExamples();
+    std::cout << "----------------------------------------\nFlatHashMap Examples:\n" << std::endl;
+    flatHashMapExamples();
     std::cout << "----------------------------------------\nList Examples:\n" << std::endl;
     listExamples();
     std::cout << "----------------------------------------\nQueue Examples:\n" << std::endl;
@@ -522,6 +791,8 @@ int main() {
     setExamples();
     std::cout << "----------------------------------------\nMultimap Examples:\n" << std::endl;
     multimapExamples();
+    std::cout << "----------------------------------------\nSnapshot Examples:\n" << std::endl;
+    snapshotExamples();
     
     return 0;
 }
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Person.h"
+
+// Benchmark suite for the container operations demonstrated in Collections.cpp
+//
+// Every operation used by vectorExamples, mapExamples, listExamples, queueExamples,
+// setExamples and multimapExamples is timed for N = 1e2, 1e3, ... up to maxN, once with
+// int and once with Person payloads. Maps and multimaps are keyed by int for the int
+// payload and by name (std::string) for the Person payload, as in the demos.
+//
+// The elements (and keys) are built before the timers start, so every insert-style
+// operation times copying a ready-made element into the container, the same for every
+// container.
+//
+// Operations that are O(N) per call on a container (insert/erase in the middle of a
+// vector, linear find) are run a fixed number of times instead of N times, so large N
+// stay practical; ns_per_op is always per single operation.
+//
+// The result is a JSON array with one object per (container, payload, operation, n),
+// suitable for diffing between builds.
+//
+// Usage: Collections_Benchmark [maxN] [output.json]   (defaults: 10000000, stdout)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+struct Measurement {
+    std::string container;
+    std::string payload;
+    std::string operation;
+    std::size_t n;
+    std::size_t ops;
+    double nsPerOp;
+};
+
+// How to build and read int and Person payloads
+template <typename T>
+struct Payload;
+
+template <>
+struct Payload<int> {
+    using Key = int;
+
+    static const char* name() { return "int"; }
+    static int make(std::size_t i) { return static_cast<int>(i); }
+    static Key key(std::size_t i) { return static_cast<int>(i); }
+    static long long value(int element) { return element; }
+};
+
+template <>
+struct Payload<Person> {
+    using Key = std::string;
+
+    static const char* name() { return "Person"; }
+    // Ages are unique, since std::set<Person> compares ages only
+    static Person make(std::size_t i) { return Person(key(i), static_cast<int>(i)); }
+    static Key key(std::size_t i) { return "person_" + std::to_string(i); }
+    static long long value(const Person& element) { return element.getAge(); }
+};
+
+class Suite {
+public:
+    Suite(std::size_t n, int repeats) : n(n), repeats(repeats) {}
+
+    // Times op(container) on a fresh container from setup(); ops is the number of
+    // operations op performs, used to report the time per operation
+    template <typename Setup, typename Op>
+    void run(const char* container, const char* payload, const char* operation, std::size_t ops, Setup setup, Op op) {
+        double best = 1e300;
+        for (int r = 0; r < repeats; ++r) {
+            auto target = setup();
+            double seconds = measureSeconds(1, [&] { op(target); });
+            best = std::min(best, seconds);
+            doNotOptimize(target);
+        }
+        results.push_back({container, payload, operation, n, ops, best * 1e9 / static_cast<double>(std::max<std::size_t>(ops, 1))});
+    }
+
+    std::vector<Measurement> results;
+    std::size_t n;
+    int repeats;
+};
+
+// The positions/keys the benchmarks touch, in random order
+std::vector<std::size_t> shuffledIndexes(std::size_t n) {
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    return order;
+}
+
+// The payloads of elements 0..n-1, built before any timer starts: the timed loops copy
+// them in, so they measure the container and not the building of strings for Person
+template <typename T>
+std::vector<T> makeElements(std::size_t n) {
+    std::vector<T> elements;
+    elements.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        elements.push_back(Payload<T>::make(i));
+    }
+    return elements;
+}
+
+// Number of calls made for operations that are O(N) each
+constexpr std::size_t kLinearOps = 16;
+
+template <typename T>
+void benchmarkVector(Suite& suite) {
+    using P = Payload<T>;
+    const std::size_t n = suite.n;
+    const std::vector<T> elements = makeElements<T>(n);
+    auto filled = [&elements] { return elements; };
+    auto none = [] { return std::vector<T>(); };
+
+    suite.run("vector", P::name(), "push_back", n, none, [&elements](std::vector<T>& v) {
+        for (const T& element : elements) {
+            v.push_back(element);
+        }
+    });
+    suite.run("vector", P::name(), "emplace_back_reserved", n, none, [&elements](std::vector<T>& v) {
+        v.reserve(elements.size());
+        for (const T& element : elements) {
+            v.emplace_back(element);
+        }
+    });
+    suite.run("vector", P::name(), "insert_middle", kLinearOps, filled, [&elements](std::vector<T>& v) {
+        for (std::size_t i = 0; i < kLinearOps; ++i) {
+            v.insert(v.begin() + v.size() / 2, elements[i % elements.size()]);
+        }
+    });
+    suite.run("vector", P::name(), "erase_middle", kLinearOps, filled, [](std::vector<T>& v) {
+        for (std::size_t i = 0; i < kLinearOps && !v.empty(); ++i) {
+            v.erase(v.begin() + v.size() / 2);
+        }
+    });
+    suite.run("vector", P::name(), "pop_back", n, filled, [](std::vector<T>& v) {
+        while (!v.empty()) {
+            v.pop_back();
+        }
+    });
+    suite.run("vector", P::name(), "find_linear", kLinearOps, filled, [n](std::vector<T>& v) {
+        long long found = 0;
+        for (std::size_t i = 0; i < kLinearOps; ++i) {
+            long long wanted = static_cast<long long>((i * 7919) % n);
+            found += std::find_if(v.begin(), v.end(), [wanted](const T& e) { return P::value(e) == wanted; }) != v.end();
+        }
+        doNotOptimize(found);
+    });
+    suite.run("vector", P::name(), "iterate", n, filled, [](std::vector<T>& v) {
+        long long sum = 0;
+        for (const T& element : v) {
+            sum += P::value(element);
+        }
+        doNotOptimize(sum);
+    });
+    suite.run("vector", P::name(), "clear", n, filled, [](std::vector<T>& v) { v.clear(); });
+}
+
+template <typename T>
+void benchmarkList(Suite& suite) {
+    using P = Payload<T>;
+    const std::size_t n = suite.n;
+    const std::vector<T> elements = makeElements<T>(n);
+    auto filled = [&elements] { return std::list<T>(elements.begin(), elements.end()); };
+    auto none = [] { return std::list<T>(); };
+
+    suite.run("list", P::name(), "push_back", n, none, [&elements](std::list<T>& l) {
+        for (const T& element : elements) {
+            l.push_back(element);
+        }
+    });
+    // Inserting and erasing at a known position is O(1) for a list
+    suite.run("list", P::name(), "insert_at_iterator", n, filled, [&elements](std::list<T>& l) {
+        auto it = std::next(l.begin(), static_cast<std::ptrdiff_t>(l.size() / 2));
+        for (const T& element : elements) {
+            it = l.insert(it, element);
+        }
+    });
+    suite.run("list", P::name(), "erase_at_iterator", n, filled, [](std::list<T>& l) {
+        for (auto it = l.begin(); it != l.end();) {
+            it = l.erase(it);
+        }
+    });
+    suite.run("list", P::name(), "pop_back", n, filled, [](std::list<T>& l) {
+        while (!l.empty()) {
+            l.pop_back();
+        }
+    });
+    suite.run("list", P::name(), "find_linear", kLinearOps, filled, [n](std::list<T>& l) {
+        long long found = 0;
+        for (std::size_t i = 0; i < kLinearOps; ++i) {
+            long long wanted = static_cast<long long>((i * 7919) % n);
+            found += std::find_if(l.begin(), l.end(), [wanted](const T& e) { return P::value(e) == wanted; }) != l.end();
+        }
+        doNotOptimize(found);
+    });
+    suite.run("list", P::name(), "iterate", n, filled, [](std::list<T>& l) {
+        long long sum = 0;
+        for (const T& element : l) {
+            sum += P::value(element);
+        }
+        doNotOptimize(sum);
+    });
+    suite.run("list", P::name(), "clear", n, filled, [](std::list<T>& l) { l.clear(); });
+}
+
+template <typename T>
+void benchmarkQueue(Suite& suite) {
+    using P = Payload<T>;
+    const std::size_t n = suite.n;
+    const std::vector<T> elements = makeElements<T>(n);
+    auto filled = [&elements] { return std::queue<T>(std::deque<T>(elements.begin(), elements.end())); };
+
+    suite.run("queue", P::name(), "push", n, [] { return std::queue<T>(); }, [&elements](std::queue<T>& q) {
+        for (const T& element : elements) {
+            q.push(element);
+        }
+    });
+    // Draining front()/pop() is how queueExamples iterates
+    suite.run("queue", P::name(), "front_pop", n, filled, [](std::queue<T>& q) {
+        long long sum = 0;
+        while (!q.empty()) {
+            sum += P::value(q.front());
+            q.pop();
+        }
+        doNotOptimize(sum);
+    });
+}
+
+template <typename T>
+void benchmarkSet(Suite& suite) {
+    using P = Payload<T>;
+    const std::size_t n = suite.n;
+    const std::vector<std::size_t> order = shuffledIndexes(n);
+    std::vector<T> elements;
+    elements.reserve(n);
+    for (std::size_t i : order) {
+        elements.push_back(P::make(i));
+    }
+    auto filled = [&elements] { return std::set<T>(elements.begin(), elements.end()); };
+
+    suite.run("set", P::name(), "insert", n, [] { return std::set<T>(); }, [&elements](std::set<T>& s) {
+        for (const T& element : elements) {
+            s.insert(element);
+        }
+    });
+    suite.run("set", P::name(), "find", n, filled, [&elements](std::set<T>& s) {
+        std::size_t found = 0;
+        for (const T& element : elements) {
+            found += s.find(element) != s.end();
+        }
+        doNotOptimize(found);
+    });
+    suite.run("set", P::name(), "erase", n, filled, [&elements](std::set<T>& s) {
+        for (const T& element : elements) {
+            s.erase(element);
+        }
+    });
+    suite.run("set", P::name(), "iterate", n, filled, [](std::set<T>& s) {
+        long long sum = 0;
+        for (const T& element : s) {
+            sum += P::value(element);
+        }
+        doNotOptimize(sum);
+    });
+    suite.run("set", P::name(), "clear", n, filled, [](std::set<T>& s) { s.clear(); });
+}
+
+// Shared by map and multimap, which have the same interface for these operations
+template <typename Map, typename T>
+void benchmarkMap(Suite& suite, const char* container) {
+    using P = Payload<T>;
+    const std::size_t n = suite.n;
+    const std::vector<std::size_t> order = shuffledIndexes(n);
+    std::vector<typename P::Key> keys;
+    std::vector<T> values;
+    keys.reserve(n);
+    values.reserve(n);
+    for (std::size_t i : order) {
+        keys.push_back(P::key(i));
+        values.push_back(P::make(i));
+    }
+    auto filled = [&] {
+        Map m;
+        for (std::size_t i = 0; i < n; ++i) {
+            m.emplace(keys[i], values[i]);
+        }
+        return m;
+    };
+
+    suite.run(container, P::name(), "insert", n, [] { return Map(); }, [&](Map& m) {
+        for (std::size_t i = 0; i < n; ++i) {
+            m.insert(std::make_pair(keys[i], values[i]));
+        }
+    });
+    suite.run(container, P::name(), "emplace", n, [] { return Map(); }, [&](Map& m) {
+        for (std::size_t i = 0; i < n; ++i) {
+            m.emplace(keys[i], values[i]);
+        }
+    });
+    suite.run(container, P::name(), "find", n, filled, [&keys](Map& m) {
+        std::size_t found = 0;
+        for (const auto& key : keys) {
+            found += m.find(key) != m.end();
+        }
+        doNotOptimize(found);
+    });
+    suite.run(container, P::name(), "erase", n, filled, [&keys](Map& m) {
+        for (const auto& key : keys) {
+            m.erase(key);
+        }
+    });
+    suite.run(container, P::name(), "iterate", n, filled, [](Map& m) {
+        long long sum = 0;
+        for (const auto& pair : m) {
+            sum += P::value(pair.second);
+        }
+        doNotOptimize(sum);
+    });
+    suite.run(container, P::name(), "clear", n, filled, [](Map& m) { m.clear(); });
+}
+
+template <typename T>
+void benchmarkPayload(Suite& suite) {
+    using Key = typename Payload<T>::Key;
+    benchmarkVector<T>(suite);
+    benchmarkMap<std::map<Key, T>, T>(suite, "map");
+    benchmarkList<T>(suite);
+    benchmarkQueue<T>(suite);
+    benchmarkSet<T>(suite);
+    benchmarkMap<std::multimap<Key, T>, T>(suite, "multimap");
+}
+
+void writeJson(std::ostream& out, const std::vector<Measurement>& results) {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Measurement& m = results[i];
+        out << "  {\"container\": \"" << m.container << "\", \"payload\": \"" << m.payload
+            << "\", \"operation\": \"" << m.operation << "\", \"n\": " << m.n << ", \"ops\": " << m.ops
+            << ", \"ns_per_op\": " << m.nsPerOp << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+int main(int argc, char** argv) {
+    std::size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    // Opened before the (long) run so a bad path fails at once
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "Cannot open " << argv[2] << " for writing" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Measurement> results;
+    for (std::size_t n = 100; n <= maxN; n *= 10) {
+        // Small sizes are repeated to get past timer resolution and noise
+        Suite suite(n, n <= 10000 ? 5 : 1);
+        benchmarkPayload<int>(suite);
+        benchmarkPayload<Person>(suite);
+        results.insert(results.end(), suite.results.begin(), suite.results.end());
+        std::cerr << "Finished n = " << n << std::endl;
+    }
+
+    if (argc > 2) {
+        writeJson(file, results);
+        file.close();
+        if (!file) {
+            std::cerr << "Cannot write results to " << argv[2] << std::endl;
+            return 1;
+        }
+    } else {
+        writeJson(std::cout, results);
+    }
+
+    return 0;
+}
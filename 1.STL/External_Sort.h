@@ -0,0 +1,405 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Parallel_Algorithms.h"
+#include "Radix_Sort.h"
+#include "Thread_Pool.h"
+
+// External merge sort for files of ints that do not fit in memory
+//
+// The files are raw arrays of native int32 values (no header), as written by writeIntFile().
+//     ExternalSortOptions options;
+//     options.memoryBudget = 512 << 20;          // bytes of RAM the sort may use
+//     externalSort("input.bin", "sorted.bin", options);
+//     SortedIntFile sorted("sorted.bin");
+//     bool found = sorted.binarySearch(42);
+//
+// It works in two phases:
+//   1. Run generation: the input is read in pieces that fit in the memory budget; each piece
+//      is sorted (radixSort, or parallelSort when options.pool is set) and written to a
+//      temporary run file.
+//   2. Merging: up to fanIn runs are merged at once through a loser tree, each run read
+//      through its own I/O buffer. When there are more runs than the budget has buffers for,
+//      the merge takes several passes.
+// Temporary files go to options.tempDirectory and are removed when the sort ends, also when
+// it fails. I/O errors throw std::runtime_error.
+
+struct ExternalSortOptions {
+    std::size_t memoryBudget = std::size_t(256) << 20; // Bytes for run data and I/O buffers
+    std::size_t ioBufferSize = std::size_t(1) << 20;   // Bytes per file buffer
+    std::filesystem::path tempDirectory = std::filesystem::temp_directory_path();
+    ThreadPool* pool = nullptr;                        // Sorts each run on this pool if set
+};
+
+struct ExternalSortStats {
+    std::uint64_t elements = 0;
+    std::size_t runs = 0;        // Sorted runs written in phase 1
+    std::size_t mergePasses = 0; // 0 if the input fit in a single run
+};
+
+// Writes values to path as a raw int32 array
+inline void writeIntFile(const std::string& path, const std::vector<int>& values) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(int)));
+    if (!out) {
+        throw std::runtime_error("writeIntFile: cannot write " + path);
+    }
+}
+
+// Reads a whole raw int32 file
+inline std::vector<int> readIntFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("readIntFile: cannot open " + path);
+    }
+    std::vector<int> values(static_cast<std::size_t>(std::filesystem::file_size(path) / sizeof(int)));
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(int)));
+    if (!in) {
+        throw std::runtime_error("readIntFile: cannot read " + path);
+    }
+    return values;
+}
+
+// Reads a raw int32 file sequentially through a buffer of a given size
+class IntFileReader {
+public:
+    IntFileReader(const std::filesystem::path& path, std::size_t bufferInts)
+        : in(path, std::ios::binary), buffer(std::max<std::size_t>(1, bufferInts)) {
+        if (!in) {
+            throw std::runtime_error("External sort: cannot open " + path.string());
+        }
+        refill();
+    }
+
+    bool empty() const {
+        return position == filled;
+    }
+
+    int front() const {
+        return buffer[position];
+    }
+
+    void pop() {
+        if (++position == filled) {
+            refill();
+        }
+    }
+
+    // Copies up to count ints into target and returns how many were copied
+    std::size_t read(int* target, std::size_t count) {
+        std::size_t copied = 0;
+        while (copied < count && !empty()) {
+            std::size_t take = std::min(count - copied, filled - position);
+            std::copy(buffer.begin() + position, buffer.begin() + position + take, target + copied);
+            copied += take;
+            position += take;
+            if (position == filled) {
+                refill();
+            }
+        }
+        return copied;
+    }
+
+private:
+    void refill() {
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(int)));
+        if (in.bad()) {
+            throw std::runtime_error("External sort: read error");
+        }
+        filled = static_cast<std::size_t>(in.gcount()) / sizeof(int);
+        position = 0;
+    }
+
+    std::ifstream in;
+    std::vector<int> buffer;
+    std::size_t position = 0;
+    std::size_t filled = 0;
+};
+
+// Writes a raw int32 file through a buffer of a given size
+class IntFileWriter {
+public:
+    IntFileWriter(const std::filesystem::path& path, std::size_t bufferInts)
+        : out(path, std::ios::binary | std::ios::trunc), buffer(std::max<std::size_t>(1, bufferInts)), path(path) {
+        if (!out) {
+            throw std::runtime_error("External sort: cannot create " + path.string());
+        }
+    }
+
+    void push(int value) {
+        if (used == buffer.size()) {
+            drain();
+        }
+        buffer[used++] = value;
+    }
+
+    void write(const int* values, std::size_t count) {
+        drain();
+        out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(int)));
+    }
+
+    // Writes what is buffered and closes the file; throws if any write failed
+    void close() {
+        drain();
+        out.close();
+        if (!out) {
+            throw std::runtime_error("External sort: cannot write " + path.string());
+        }
+    }
+
+private:
+    void drain() {
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(used * sizeof(int)));
+        used = 0;
+    }
+
+    std::ofstream out;
+    std::vector<int> buffer;
+    std::size_t used = 0;
+    std::filesystem::path path;
+};
+
+// Loser tree over k sorted inputs: the smallest current value among them in O(log k)
+// comparisons per element, against about 2 log k for a binary heap.
+// Leaves are the inputs, k..2k-1; every inner node keeps the input that lost the match played
+// there, and the overall winner is kept apart. After the winner advances only the matches on
+// its own path to the root are replayed.
+class LoserTree {
+public:
+    explicit LoserTree(std::vector<IntFileReader>& inputs) : inputs(inputs), losers(inputs.size()) {
+        const std::size_t k = inputs.size();
+        std::vector<std::size_t> winners(2 * k);
+        for (std::size_t i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (std::size_t node = k - 1; node >= 1; --node) {
+            std::size_t a = winners[2 * node];
+            std::size_t b = winners[2 * node + 1];
+            winners[node] = beats(b, a) ? b : a;
+            losers[node] = beats(b, a) ? a : b;
+        }
+        winner = k > 1 ? winners[1] : 0;
+    }
+
+    bool empty() const {
+        return inputs[winner].empty();
+    }
+
+    // Removes and returns the smallest value; the tree must not be empty
+    int pop() {
+        int value = inputs[winner].front();
+        inputs[winner].pop();
+        std::size_t current = winner;
+        for (std::size_t node = (current + inputs.size()) / 2; node >= 1; node /= 2) {
+            if (beats(losers[node], current)) {
+                std::swap(losers[node], current);
+            }
+        }
+        winner = current;
+        return value;
+    }
+
+private:
+    // Whether input a wins against input b; an exhausted input loses to everything
+    bool beats(std::size_t a, std::size_t b) const {
+        if (inputs[a].empty()) {
+            return false;
+        }
+        return inputs[b].empty() || inputs[a].front() < inputs[b].front();
+    }
+
+    std::vector<IntFileReader>& inputs;
+    std::vector<std::size_t> losers;
+    std::size_t winner = 0;
+};
+
+// Temporary run files with unique names, removed by the destructor
+class TemporaryRunFiles {
+public:
+    explicit TemporaryRunFiles(std::filesystem::path directory) : directory(std::move(directory)) {
+        std::random_device random;
+        prefix = "external_sort_" + std::to_string(random()) + "_";
+    }
+
+    ~TemporaryRunFiles() {
+        for (const std::filesystem::path& file : files) {
+            std::error_code ignored;
+            std::filesystem::remove(file, ignored);
+        }
+    }
+
+    TemporaryRunFiles(const TemporaryRunFiles&) = delete;
+    TemporaryRunFiles& operator=(const TemporaryRunFiles&) = delete;
+
+    std::filesystem::path create() {
+        files.push_back(directory / (prefix + std::to_string(files.size()) + ".run"));
+        return files.back();
+    }
+
+    void remove(const std::filesystem::path& file) {
+        std::error_code ignored;
+        std::filesystem::remove(file, ignored);
+    }
+
+private:
+    std::filesystem::path directory;
+    std::string prefix;
+    std::vector<std::filesystem::path> files;
+};
+
+// Merges the sorted runs into target with one loser tree
+inline void mergeRuns(const std::vector<std::filesystem::path>& runs, const std::filesystem::path& target,
+                      std::size_t bufferInts) {
+    std::vector<IntFileReader> inputs;
+    inputs.reserve(runs.size());
+    for (const std::filesystem::path& run : runs) {
+        inputs.emplace_back(run, bufferInts);
+    }
+    IntFileWriter out(target, bufferInts);
+    LoserTree tree(inputs);
+    while (!tree.empty()) {
+        out.push(tree.pop());
+    }
+    out.close();
+}
+
+// Sorts the int32 file input into output (which may not be the same file)
+inline ExternalSortStats externalSort(const std::string& input, const std::string& output,
+                                      const ExternalSortOptions& options = ExternalSortOptions()) {
+    const std::size_t bufferInts = std::max<std::size_t>(1024, options.ioBufferSize / sizeof(int));
+    // A run and the scratch buffer of its sort share the budget, minus the input buffer
+    const std::size_t budgetInts = options.memoryBudget / sizeof(int);
+    const std::size_t runInts = std::max<std::size_t>(bufferInts, (budgetInts - std::min(budgetInts, bufferInts)) / 2);
+    // While merging, every input and the output need a buffer. A budget below three
+    // buffers still merges two runs at a time (clamped before subtracting, so it cannot wrap)
+    const std::size_t fanIn = std::max<std::size_t>(3, budgetInts / bufferInts) - 1;
+
+    ExternalSortStats stats;
+    TemporaryRunFiles temporary(options.tempDirectory);
+    std::vector<std::filesystem::path> runs;
+    {
+        IntFileReader in(input, bufferInts);
+        std::vector<int> run(runInts);
+        std::vector<int> scratch;
+        for (;;) {
+            std::size_t count = in.read(run.data(), runInts);
+            if (count == 0) {
+                break;
+            }
+            stats.elements += count;
+            if (options.pool != nullptr) {
+                parallelSort(*options.pool, run.begin(), run.begin() + static_cast<std::ptrdiff_t>(count));
+            } else {
+                scratch.resize(count);
+                radixSort(run.data(), run.data() + count, scratch.data());
+            }
+            // A single run is already the result
+            const bool only = runs.empty() && in.empty();
+            runs.push_back(only ? std::filesystem::path(output) : temporary.create());
+            IntFileWriter out(runs.back(), bufferInts);
+            out.write(run.data(), count);
+            out.close();
+            if (only) {
+                stats.runs = 1;
+                return stats;
+            }
+        }
+    }
+    stats.runs = runs.size();
+    if (runs.empty()) {
+        IntFileWriter(output, 1).close(); // Empty input gives an empty output
+        return stats;
+    }
+
+    // Merge groups of fanIn runs until one group is left, which is merged into the output
+    while (runs.size() > 1) {
+        ++stats.mergePasses;
+        const bool last = runs.size() <= fanIn;
+        std::vector<std::filesystem::path> merged;
+        for (std::size_t first = 0; first < runs.size(); first += fanIn) {
+            std::vector<std::filesystem::path> group(runs.begin() + static_cast<std::ptrdiff_t>(first),
+                                                     runs.begin() + static_cast<std::ptrdiff_t>(
+                                                                        std::min(runs.size(), first + fanIn)));
+            merged.push_back(last ? std::filesystem::path(output) : temporary.create());
+            mergeRuns(group, merged.back(), bufferInts);
+            for (const std::filesystem::path& run : group) {
+                temporary.remove(run);
+            }
+        }
+        runs.swap(merged);
+    }
+    return stats;
+}
+
+// Binary search over a sorted int32 file without loading it
+//
+// The search narrows the range with single-int reads until it fits in one block of
+// blockInts values, then reads that block and finishes in memory, so a lookup costs about
+// log2(n / blockInts) + 1 reads. The file stays open between lookups.
+class SortedIntFile {
+public:
+    explicit SortedIntFile(const std::string& path, std::size_t blockInts = 1024)
+        : in(path, std::ios::binary), blockInts(std::max<std::size_t>(1, blockInts)), block(this->blockInts + 1) {
+        if (!in) {
+            throw std::runtime_error("SortedIntFile: cannot open " + path);
+        }
+        count = static_cast<std::uint64_t>(std::filesystem::file_size(path) / sizeof(int));
+    }
+
+    std::uint64_t size() const {
+        return count;
+    }
+
+    // Same result as std::binary_search on the file's contents
+    bool binarySearch(int value) {
+        std::uint64_t low = 0;
+        std::uint64_t high = count;
+        // Everything before low is less than value, everything from high on is not
+        while (high - low > blockInts) {
+            std::uint64_t middle = low + (high - low) / 2;
+            if (readAt(middle) < value) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        // The first element not less than value is in [low, high], so the block includes high
+        const std::size_t length = static_cast<std::size_t>(std::min(high + 1, count) - low);
+        seek(low);
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(length * sizeof(int)));
+        if (!in) {
+            throw std::runtime_error("SortedIntFile: read error");
+        }
+        return std::binary_search(block.begin(), block.begin() + static_cast<std::ptrdiff_t>(length), value);
+    }
+
+private:
+    void seek(std::uint64_t index) {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(index * sizeof(int)));
+    }
+
+    int readAt(std::uint64_t index) {
+        int value = 0;
+        seek(index);
+        in.read(reinterpret_cast<char*>(&value), sizeof(int));
+        if (!in) {
+            throw std::runtime_error("SortedIntFile: read error");
+        }
+        return value;
+    }
+
+    std::ifstream in;
+    std::size_t blockInts;
+    std::vector<int> block;
+    std::uint64_t count = 0;
+};
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "External_Sort.h"
+
+// Sorts a file of random ints with externalSort() under a memory budget much smaller than
+// the file, serially and on a thread pool, then times SortedIntFile::binarySearch lookups.
+// The data is also sorted in memory with std::sort as a reference: the output file must hold
+// exactly that sequence, and every lookup must agree with std::binary_search. Any difference
+// is reported and makes the program exit with status 1.
+//
+// Usage: External_Sort_Benchmark [elements] [budgetMB] [directory]
+//        (defaults: 100000000, 64, the system temp directory)
+// Build with optimizations and threads, e.g. g++ -std=c++17 -O3 -pthread
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    std::size_t budgetMB = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    std::filesystem::path directory = argc > 3 ? std::filesystem::path(argv[3]) : std::filesystem::temp_directory_path();
+    const std::string input = (directory / "external_sort_input.bin").string();
+    const std::string output = (directory / "external_sort_output.bin").string();
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(-1000000000, 1000000000);
+    std::vector<int> data(elements);
+    for (int& value : data) {
+        value = dis(gen);
+    }
+    writeIntFile(input, data);
+    double stdSortTime = measureSeconds(1, [&] { std::sort(data.begin(), data.end()); });
+
+    ExternalSortOptions options;
+    options.memoryBudget = budgetMB << 20;
+    options.tempDirectory = directory;
+    std::cout << "Elements: " << elements << " (" << elements * sizeof(int) / 1000000.0 << " MB), memory budget: "
+              << budgetMB << " MB" << std::endl;
+    std::cout << "std::sort in memory:       " << stdSortTime << " s" << std::endl;
+
+    bool ok = true;
+    ThreadPool pool;
+    for (ThreadPool* runPool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        options.pool = runPool;
+        ExternalSortStats stats;
+        double seconds = measureSeconds(1, [&] { stats = externalSort(input, output, options); });
+        if (readIntFile(output) != data) {
+            std::cout << "MISMATCH: external sort output differs from std::sort" << std::endl;
+            ok = false;
+        }
+        std::cout << "externalSort, " << (runPool ? std::to_string(pool.size()) + " threads: " : "serial:    ")
+                  << "   " << seconds << " s (" << stats.runs << " runs, " << stats.mergePasses
+                  << " merge passes, " << static_cast<double>(elements * sizeof(int)) / seconds / 1e6 << " MB/s)"
+                  << std::endl;
+    }
+
+    const std::size_t lookups = 100000;
+    std::vector<int> probes(lookups);
+    for (int& probe : probes) {
+        probe = dis(gen);
+    }
+    SortedIntFile sorted(output);
+    std::size_t mismatches = 0;
+    double lookupTime = measureSeconds(1, [&] {
+        for (int probe : probes) {
+            mismatches += sorted.binarySearch(probe) != std::binary_search(data.begin(), data.end(), probe);
+        }
+    });
+    if (mismatches != 0) {
+        std::cout << "MISMATCH: " << mismatches << " file lookups differ from std::binary_search" << std::endl;
+        ok = false;
+    }
+    std::cout << "SortedIntFile::binarySearch: " << lookupTime / static_cast<double>(lookups) * 1e6
+              << " us per lookup" << std::endl;
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+    std::cout << (ok ? "External sort results match std::sort." : "External sort results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
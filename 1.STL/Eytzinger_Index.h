@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+// EytzingerIndex: a static membership index over a sorted std::vector<int>
+//
+// std::binary_search on a large array costs about log2(n) cache misses per probe, and each
+// one has to finish before the next address is known. EytzingerIndex stores the same values
+// in breadth-first order of the search tree (node k has children 2k and 2k+1), so:
+//   - the top levels of the tree, which every probe visits, share a few hot cache lines;
+//   - the 16 descendants four levels below node k sit in one cache line, so that line is
+//     prefetched while the next four comparisons run;
+//   - each step is k = 2k + (value < x), which compiles to a conditional move.
+//
+//     EytzingerIndex index(sortedVec);               // ascending or descending input
+//     bool found = index.contains(5);
+//     std::vector<char> hits(queries.size());
+//     index.contains(queries, hits);                 // batched lookups
+// The batched overloads walk several probes down the tree in lockstep, so their cache
+// misses overlap instead of being paid one after the other.
+//
+// The input must be sorted in ascending or descending order (as produced by std::sort with
+// or without std::greater<int>()); the direction is detected from its first and last element.
+// The index is a copy, so later changes to the vector are not seen.
+class EytzingerIndex {
+public:
+    EytzingerIndex() = default;
+
+    explicit EytzingerIndex(const std::vector<int>& sorted) : count(sorted.size()) {
+        // Slot 0 is the start of a line, so the 16 nodes four levels below any node k,
+        // slots 16k to 16k+15, fill exactly one line
+        lines.resize((count + 1 + 15) / 16);
+        nodes = lines.data()->values;
+        const bool descending = !sorted.empty() && sorted.front() > sorted.back();
+        std::size_t next = 0;
+        if (descending) {
+            std::vector<int> ascending(sorted.rbegin(), sorted.rend());
+            fill(ascending, next, 1);
+        } else {
+            fill(sorted, next, 1);
+        }
+    }
+
+    EytzingerIndex(const EytzingerIndex& other) : lines(other.lines), count(other.count) {
+        nodes = lines.empty() ? nullptr : lines.data()->values;
+    }
+
+    EytzingerIndex& operator=(const EytzingerIndex& other) {
+        lines = other.lines;
+        count = other.count;
+        nodes = lines.empty() ? nullptr : lines.data()->values;
+        return *this;
+    }
+
+    EytzingerIndex(EytzingerIndex&& other) noexcept
+        : lines(std::move(other.lines)), nodes(std::exchange(other.nodes, nullptr)),
+          count(std::exchange(other.count, 0)) {}
+
+    EytzingerIndex& operator=(EytzingerIndex&& other) noexcept {
+        lines = std::move(other.lines);
+        nodes = std::exchange(other.nodes, nullptr);
+        count = std::exchange(other.count, 0);
+        return *this;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    // Same result as std::binary_search on the original vector
+    bool contains(int value) const {
+        std::size_t k = 1;
+        while (k <= count) {
+            prefetch(k * 16);
+            k = 2 * k + (nodes[k] < value);
+        }
+        k = lowerBoundSlot(k);
+        return k != 0 && nodes[k] == value;
+    }
+
+    // found[i] = contains(values[i]) for every i in [0, valueCount)
+    void contains(const int* values, std::size_t valueCount, char* found) const {
+        std::size_t i = 0;
+        for (; count > 0 && i + kBatch <= valueCount; i += kBatch) {
+            containsBatch(values + i, found + i);
+        }
+        for (; i < valueCount; ++i) {
+            found[i] = contains(values[i]);
+        }
+    }
+
+    // found is resized to values.size()
+    void contains(const std::vector<int>& values, std::vector<char>& found) const {
+        found.resize(values.size());
+        contains(values.data(), values.size(), found.data());
+    }
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+    // found must be at least as long as values
+    void contains(std::span<const int> values, std::span<char> found) const {
+        contains(values.data(), values.size(), found.data());
+    }
+#endif
+
+private:
+    // Probes that go down the tree together in the batched lookup
+    static constexpr std::size_t kBatch = 16;
+
+    struct alignas(64) CacheLine {
+        int values[16];
+    };
+
+    // In-order walk of the tree, which hands out the sorted values in order
+    void fill(const std::vector<int>& sorted, std::size_t& next, std::size_t k) {
+        if (k <= count) {
+            fill(sorted, next, 2 * k);
+            nodes[k] = sorted[next++];
+            fill(sorted, next, 2 * k + 1);
+        }
+    }
+
+    // The walk ends at a k past the last node; the path to it is k's binary digits, and the
+    // last step to the left (the lowest 0 bit) was taken at the first value not less than x.
+    // Returns that node, or 0 if every value is less than x.
+    static std::size_t lowerBoundSlot(std::size_t k) {
+        while (k & 1) {
+            k >>= 1;
+        }
+        return k >> 1;
+    }
+
+    void prefetch(std::size_t slot) const {
+#if defined(__GNUC__) || defined(__clang__)
+        // Only a hint: an address past the end of the tree is never dereferenced
+        __builtin_prefetch(reinterpret_cast<const char*>(nodes) + slot * sizeof(int));
+#else
+        (void)slot;
+#endif
+    }
+
+    void containsBatch(const int* values, char* found) const {
+        std::size_t k[kBatch];
+        for (std::size_t j = 0; j < kBatch; ++j) {
+            k[j] = 1;
+        }
+        // Every probe has left the tree after depth + 1 steps; a probe that is already out
+        // stays where it is, without a branch
+        std::size_t depth = 0;
+        while ((std::size_t(2) << depth) <= count) {
+            ++depth;
+        }
+        for (std::size_t step = 0; step <= depth; ++step) {
+            for (std::size_t j = 0; j < kBatch; ++j) {
+                const bool inside = k[j] <= count;
+                const std::size_t slot = inside ? k[j] : 0;
+                prefetch(slot * 16);
+                const std::size_t down = 2 * k[j] + (nodes[slot] < values[j]);
+                k[j] = inside ? down : k[j];
+            }
+        }
+        for (std::size_t j = 0; j < kBatch; ++j) {
+            const std::size_t slot = lowerBoundSlot(k[j]);
+            found[j] = slot != 0 && nodes[slot] == values[j];
+        }
+    }
+
+    std::vector<CacheLine> lines;
+    int* nodes = nullptr; // nodes[1] is the root; nodes[0] is an unused spare
+    std::size_t count = 0;
+};
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Branchless_Search.h"
+#include "Eytzinger_Index.h"
+
+// Membership probe throughput on sorted int arrays of 1e3 to maxN elements:
+// std::binary_search, branchlessLowerBound (Branchless_Search.h), EytzingerIndex::contains
+// one probe at a time, and the batched EytzingerIndex::contains.
+// Half of the probes are present in the array. The index is also built from the same array
+// sorted in descending order and must give the same answers. Any difference from
+// std::binary_search is reported and makes the program exit with status 1.
+//
+// Usage: Eytzinger_Index_Benchmark [maxN] [probes]   (defaults: 100000000 and 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+int main(int argc, char** argv) {
+    std::size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    std::size_t probeCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    const int repeats = 3;
+
+    std::mt19937 gen(42);
+    bool ok = true;
+
+    std::cout << "Probes: " << probeCount << " (million probes per second)" << std::endl;
+    std::cout << std::right << std::setw(11) << "n" << std::setw(15) << "binary_search" << std::setw(13)
+              << "branchless" << std::setw(13) << "eytzinger" << std::setw(13) << "batched" << std::setw(9)
+              << "speedup" << std::endl;
+    for (std::size_t n = 1000; n <= maxN; n *= 10) {
+        // Even numbers only, so every odd probe is a guaranteed miss
+        std::vector<int> sorted(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::uniform_int_distribution<int> dis(0, static_cast<int>(2 * n));
+        std::vector<int> probes(probeCount);
+        for (int& probe : probes) {
+            probe = dis(gen);
+        }
+
+        EytzingerIndex index(sorted);
+        std::vector<char> expected(probeCount);
+        std::vector<char> hits(probeCount);
+
+        double stdTime = measureSeconds(repeats, [&] {
+            for (std::size_t i = 0; i < probeCount; ++i) {
+                expected[i] = std::binary_search(sorted.begin(), sorted.end(), probes[i]);
+            }
+            doNotOptimize(expected.data());
+        });
+        double branchlessTime = measureSeconds(repeats, [&] {
+            for (std::size_t i = 0; i < probeCount; ++i) {
+                auto it = branchlessLowerBound(sorted.begin(), sorted.end(), probes[i], std::less<int>());
+                hits[i] = it != sorted.end() && *it == probes[i];
+            }
+            doNotOptimize(hits.data());
+        });
+        ok = ok && hits == expected;
+        double singleTime = measureSeconds(repeats, [&] {
+            for (std::size_t i = 0; i < probeCount; ++i) {
+                hits[i] = index.contains(probes[i]);
+            }
+            doNotOptimize(hits.data());
+        });
+        ok = ok && hits == expected;
+        double batchTime = measureSeconds(repeats, [&] {
+            index.contains(probes, hits);
+            doNotOptimize(hits.data());
+        });
+        ok = ok && hits == expected;
+
+        std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+        EytzingerIndex descendingIndex(sorted);
+        descendingIndex.contains(probes, hits);
+        ok = ok && hits == expected;
+        if (!ok) {
+            std::cout << "MISMATCH with std::binary_search at n = " << n << std::endl;
+            return 1;
+        }
+
+        auto rate = [probeCount](double seconds) { return static_cast<double>(probeCount) / seconds / 1e6; };
+        std::cout << std::setw(11) << n << std::fixed << std::setprecision(1) << std::setw(15) << rate(stdTime)
+                  << std::setw(13) << rate(branchlessTime) << std::setw(13) << rate(singleTime) << std::setw(13)
+                  << rate(batchTime) << std::setw(8) << std::setprecision(2) << stdTime / batchTime << "x"
+                  << std::endl;
+    }
+
+    std::cout << "All EytzingerIndex results match std::binary_search." << std::endl;
+    return 0;
+}
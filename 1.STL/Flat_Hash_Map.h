@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// FlatHashMap: an open-addressing hash map with heterogeneous lookup
+//
+// std::map<std::string, int> keeps every entry in its own heap node and walks a
+// red-black tree on each lookup; find("Charlie") also has to build a temporary
+// std::string first. FlatHashMap stores all entries in one contiguous slot array
+// and probes it linearly, so a lookup usually touches one or two cache lines.
+// With the default hasher a FlatHashMap<std::string, T> accepts std::string_view
+// and const char* keys for find/count/contains/erase/at without allocating.
+//
+// Differences to std::map:
+//  - iteration order is unspecified (not sorted by key)
+//  - insert/emplace/erase may invalidate iterators (rehash), like std::unordered_map
+
+// Default hasher. std::hash is used for the actual hashing; the result is mixed
+// afterwards because std::hash<int> is the identity and we take bits from both ends.
+template <typename Key>
+struct FlatHash {
+    std::size_t operator()(const Key& key) const {
+        return std::hash<Key>()(key);
+    }
+};
+
+// Strings hash through std::string_view, so every string-like key hashes the same
+template <>
+struct FlatHash<std::string> {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view key) const {
+        return std::hash<std::string_view>()(key);
+    }
+};
+
+template <typename Key, typename T, typename Hash = FlatHash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+private:
+    // Control bytes: one per slot. A full slot stores the low 7 bits of its hash,
+    // which filters out almost every non-matching key without touching the slot.
+    static constexpr std::int8_t kEmpty = -128;
+    static constexpr std::int8_t kDeleted = -2;
+
+    template <typename Value>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator() = default;
+
+        // Allows converting an iterator to a const_iterator
+        template <typename Other, typename = std::enable_if_t<std::is_convertible_v<Other*, Value*>>>
+        Iterator(const Iterator<Other>& other) : control(other.control), slot(other.slot), end(other.end) {}
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        Iterator& operator++() {
+            ++control;
+            ++slot;
+            skipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const Iterator& other) const { return slot == other.slot; }
+        bool operator!=(const Iterator& other) const { return slot != other.slot; }
+
+    private:
+        friend class FlatHashMap;
+        template <typename> friend class Iterator;
+
+        Iterator(const std::int8_t* control, Value* slot, const std::int8_t* end)
+            : control(control), slot(slot), end(end) {
+            skipEmpty();
+        }
+
+        void skipEmpty() {
+            while (control != end && *control < 0) {
+                ++control;
+                ++slot;
+            }
+        }
+
+        const std::int8_t* control = nullptr;
+        Value* slot = nullptr;
+        const std::int8_t* end = nullptr;
+    };
+
+public:
+    using iterator = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(size_type expectedSize) {
+        reserve(expectedSize);
+    }
+
+    FlatHashMap(std::initializer_list<value_type> init) {
+        reserve(init.size());
+        for (const value_type& value : init) {
+            insert(value);
+        }
+    }
+
+    FlatHashMap(const FlatHashMap& other) {
+        reserve(other.size());
+        for (const value_type& value : other) {
+            insert(value);
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept {
+        swap(other);
+    }
+
+    FlatHashMap& operator=(FlatHashMap other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        destroyAll();
+        deallocate();
+    }
+
+    // Iterators
+    iterator begin() { return iterator(control, slots, control + capacity); }
+    iterator end() { return iterator(control + capacity, slots + capacity, control + capacity); }
+    const_iterator begin() const { return const_iterator(control, slots, control + capacity); }
+    const_iterator end() const { return const_iterator(control + capacity, slots + capacity, control + capacity); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // Capacity
+    bool empty() const { return elementCount == 0; }
+    size_type size() const { return elementCount; }
+    size_type bucket_count() const { return capacity; }
+    float load_factor() const { return capacity == 0 ? 0.0f : static_cast<float>(elementCount) / capacity; }
+
+    // Makes room for n elements without further rehashing
+    void reserve(size_type n) {
+        size_type needed = 16;
+        while (needed * 7 / 8 < n) {
+            needed *= 2;
+        }
+        if (needed > capacity) {
+            rehash(needed);
+        }
+    }
+
+    // Lookup
+    template <typename K = Key>
+    iterator find(const K& key) {
+        size_type index = findIndex(key);
+        return index == kNotFound ? end() : iteratorAt(index);
+    }
+
+    template <typename K = Key>
+    const_iterator find(const K& key) const {
+        size_type index = findIndex(key);
+        return index == kNotFound ? end() : const_iterator(control + index, slots + index, control + capacity);
+    }
+
+    template <typename K = Key>
+    bool contains(const K& key) const {
+        return findIndex(key) != kNotFound;
+    }
+
+    template <typename K = Key>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename K = Key>
+    T& at(const K& key) {
+        size_type index = findIndex(key);
+        if (index == kNotFound) {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].second;
+    }
+
+    template <typename K = Key>
+    const T& at(const K& key) const {
+        size_type index = findIndex(key);
+        if (index == kNotFound) {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].second;
+    }
+
+    // Inserts a default-constructed value if the key is missing. The key is only
+    // converted to Key (e.g. std::string_view -> std::string) when it is inserted.
+    template <typename K = Key>
+    T& operator[](const K& key) {
+        return try_emplace(key).first->second;
+    }
+
+    // Modifiers
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    template <typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+    std::pair<iterator, bool> insert(P&& value) {
+        return emplace(std::forward<P>(value));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    // Like std::map::emplace: builds the pair first, then inserts it if the key is new
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return try_emplace(std::move(const_cast<Key&>(value.first)), std::move(value.second));
+    }
+
+    // Constructs the value in place only if the key is not present yet
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        const std::size_t hash = hashOf(key);
+        size_type index = findIndex(key, hash);
+        if (index != kNotFound) {
+            return {iteratorAt(index), false};
+        }
+        if ((elementCount + tombstones + 1) * 8 > capacity * 7) {
+            // Rehash in place when tombstones are the problem, grow otherwise
+            rehash(elementCount * 2 >= capacity ? (capacity == 0 ? 16 : capacity * 2) : capacity);
+        }
+        index = findInsertIndex(hash);
+        if (control[index] == kDeleted) {
+            --tombstones;
+        }
+        ::new (static_cast<void*>(slots + index)) value_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(Key(std::forward<K>(key))),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        control[index] = h2(hash);
+        ++elementCount;
+        return {iteratorAt(index), true};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    // Erases the element with the given key; returns the number of erased elements (0 or 1)
+    template <typename K = Key, typename = std::enable_if_t<!std::is_convertible_v<const K&, const_iterator>>>
+    size_type erase(const K& key) {
+        size_type index = findIndex(key);
+        if (index == kNotFound) {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+
+    // Erasing never moves other elements, so the returned iterator stays valid
+    iterator erase(const_iterator pos) {
+        size_type index = static_cast<size_type>(pos.slot - slots);
+        eraseAt(index);
+        return iteratorAt(index);
+    }
+
+    void clear() {
+        destroyAll();
+        if (capacity > 0) {
+            std::fill(control, control + capacity, kEmpty);
+        }
+        elementCount = 0;
+        tombstones = 0;
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(control, other.control);
+        std::swap(slots, other.slots);
+        std::swap(capacity, other.capacity);
+        std::swap(elementCount, other.elementCount);
+        std::swap(tombstones, other.tombstones);
+    }
+
+private:
+    static constexpr size_type kNotFound = static_cast<size_type>(-1);
+
+    template <typename K>
+    static std::size_t hashOf(const K& key) {
+        // Multiplicative mixing (Fibonacci hashing) spreads weak hashes over all bits
+        std::uint64_t h = static_cast<std::uint64_t>(Hash()(key));
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+
+    static std::int8_t h2(std::size_t hash) {
+        return static_cast<std::int8_t>(hash & 0x7F);
+    }
+
+    size_type h1(std::size_t hash) const {
+        return (hash >> 7) & (capacity - 1);
+    }
+
+    iterator iteratorAt(size_type index) {
+        return iterator(control + index, slots + index, control + capacity);
+    }
+
+    template <typename K>
+    size_type findIndex(const K& key) const {
+        return capacity == 0 ? kNotFound : findIndex(key, hashOf(key));
+    }
+
+    // Linear probing: the probe sequence ends at the first empty slot
+    template <typename K>
+    size_type findIndex(const K& key, std::size_t hash) const {
+        if (capacity == 0) {
+            return kNotFound;
+        }
+        const std::int8_t tag = h2(hash);
+        const size_type mask = capacity - 1;
+        for (size_type index = h1(hash);; index = (index + 1) & mask) {
+            const std::int8_t c = control[index];
+            if (c == tag && KeyEqual()(slots[index].first, key)) {
+                return index;
+            }
+            if (c == kEmpty) {
+                return kNotFound;
+            }
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence
+    size_type findInsertIndex(std::size_t hash) const {
+        const size_type mask = capacity - 1;
+        size_type index = h1(hash);
+        while (control[index] >= 0) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void eraseAt(size_type index) {
+        slots[index].~value_type();
+        // If the next slot is empty no probe sequence passes through here,
+        // so the slot can become empty again instead of a tombstone
+        if (control[(index + 1) & (capacity - 1)] == kEmpty) {
+            control[index] = kEmpty;
+        } else {
+            control[index] = kDeleted;
+            ++tombstones;
+        }
+        --elementCount;
+    }
+
+    void rehash(size_type newCapacity) {
+        std::int8_t* oldControl = control;
+        value_type* oldSlots = slots;
+        size_type oldCapacity = capacity;
+
+        // Both arrays are allocated before any member changes, so a bad_alloc leaves the
+        // map as it was
+        std::int8_t* newControl = static_cast<std::int8_t*>(::operator new(newCapacity));
+        value_type* newSlots;
+        try {
+            newSlots = static_cast<value_type*>(::operator new(newCapacity * sizeof(value_type), std::align_val_t(alignof(value_type))));
+        } catch (...) {
+            ::operator delete(newControl);
+            throw;
+        }
+        std::fill(newControl, newControl + newCapacity, kEmpty);
+
+        control = newControl;
+        slots = newSlots;
+        capacity = newCapacity;
+        tombstones = 0;
+
+        for (size_type i = 0; i < oldCapacity; ++i) {
+            if (oldControl[i] >= 0) {
+                value_type& old = oldSlots[i];
+                const std::size_t hash = hashOf(old.first);
+                size_type index = findInsertIndex(hash);
+                ::new (static_cast<void*>(slots + index)) value_type(
+                    std::move(const_cast<Key&>(old.first)), std::move(old.second));
+                control[index] = h2(hash);
+                old.~value_type();
+            }
+        }
+
+        if (oldCapacity > 0) {
+            ::operator delete(oldControl);
+            ::operator delete(oldSlots, std::align_val_t(alignof(value_type)));
+        }
+    }
+
+    void destroyAll() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity; ++i) {
+                if (control[i] >= 0) {
+                    slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    void deallocate() {
+        if (capacity > 0) {
+            ::operator delete(control);
+            ::operator delete(slots, std::align_val_t(alignof(value_type)));
+        }
+        control = nullptr;
+        slots = nullptr;
+        capacity = 0;
+    }
+
+    std::int8_t* control = nullptr;
+    value_type* slots = nullptr;
+    size_type capacity = 0;   // Always zero or a power of two
+    size_type elementCount = 0;
+    size_type tombstones = 0;
+};
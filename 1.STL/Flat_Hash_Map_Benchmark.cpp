@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Flat_Hash_Map.h"
+
+// Compares the ageMap workload from mapExamples() (insert, find, operator[], erase)
+// on std::map, std::unordered_map and FlatHashMap for 1e3 to 1e7 keys.
+// Lookups are done with std::string_view keys, as they would arrive from a parser:
+// the std containers have to build a std::string for each one, FlatHashMap does not.
+//
+// Usage: Flat_Hash_Map_Benchmark [maxKeys]   (default: 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+struct Result {
+    double insertNs;
+    double findNs;
+    double eraseNs;
+    std::size_t checksum;
+};
+
+// Runs the workload on one container type; `lookup` turns a string_view into the key type it needs
+template <typename Map, typename Lookup>
+Result runWorkload(const std::vector<std::string>& keys, const std::vector<std::string_view>& probes, Lookup lookup) {
+    Result result{};
+    const double n = static_cast<double>(keys.size());
+    Map map;
+
+    result.insertNs = measureSeconds(1, [&] {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            map.emplace(keys[i], static_cast<int>(i));
+        }
+    }) * 1e9 / n;
+
+    std::size_t checksum = 0;
+    result.findNs = measureSeconds(1, [&] {
+        for (std::string_view probe : probes) {
+            auto it = map.find(lookup(probe));
+            if (it != map.end()) {
+                checksum += static_cast<std::size_t>(it->second);
+            }
+        }
+    }) * 1e9 / static_cast<double>(probes.size());
+
+    result.eraseNs = measureSeconds(1, [&] {
+        for (std::size_t i = 0; i < keys.size(); i += 2) {
+            checksum += map.erase(lookup(keys[i]));
+        }
+    }) * 1e9 / (n / 2);
+
+    result.checksum = checksum + map.size();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::size_t maxKeys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    auto toString = [](std::string_view key) { return std::string(key); };
+    auto asView = [](std::string_view key) { return key; };
+
+    std::cout << std::setw(10) << "keys" << std::setw(22) << "container"
+              << std::setw(14) << "insert ns" << std::setw(14) << "find ns" << std::setw(14) << "erase ns" << std::endl;
+
+    for (std::size_t n = 1000; n <= maxKeys; n *= 10) {
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back("person_" + std::to_string(i * 2654435761u % 1000000007u));
+        }
+
+        // Half of the probes hit, half miss
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<std::size_t> dis(0, n - 1);
+        std::vector<std::string> misses;
+        std::vector<std::string_view> probes;
+        misses.reserve(n);
+        probes.reserve(2 * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            misses.push_back("nobody_" + std::to_string(i));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            probes.push_back(keys[dis(gen)]);
+            probes.push_back(misses[dis(gen)]);
+        }
+
+        Result results[] = {
+            runWorkload<std::map<std::string, int>>(keys, probes, toString),
+            runWorkload<std::unordered_map<std::string, int>>(keys, probes, toString),
+            runWorkload<FlatHashMap<std::string, int>>(keys, probes, asView),
+        };
+        const char* names[] = {"std::map", "std::unordered_map", "FlatHashMap"};
+
+        for (int i = 0; i < 3; ++i) {
+            std::cout << std::setw(10) << n << std::setw(22) << names[i] << std::fixed << std::setprecision(1)
+                      << std::setw(14) << results[i].insertNs << std::setw(14) << results[i].findNs
+                      << std::setw(14) << results[i].eraseNs << std::endl;
+        }
+
+        if (results[0].checksum != results[1].checksum || results[0].checksum != results[2].checksum) {
+            std::cout << "Checksum mismatch at " << n << " keys!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Branchless_Search.h"
+
+// FlatMultimap: a sorted std::vector of key-value pairs with the interface of std::multimap
+//
+// Like FlatSet, it trades O(n) single inserts and erases for contiguous storage and
+// branchless lookups. Elements with equal keys stay in insertion order, as in std::multimap.
+// The default comparator is std::less<>, so a FlatMultimap<std::string, int> can be
+// searched with string literals and std::string_view without building a std::string.
+//
+// Values can be modified through iterators; keys must not be, since that would break the order.
+template <typename Key, typename T, typename Compare = std::less<>>
+class FlatMultimap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+    using reverse_iterator = typename std::vector<value_type>::reverse_iterator;
+    using const_reverse_iterator = typename std::vector<value_type>::const_reverse_iterator;
+
+    // Compares elements by key only
+    class value_compare {
+    public:
+        explicit value_compare(const Compare& comp) : comp(comp) {}
+
+        bool operator()(const value_type& a, const value_type& b) const { return comp(a.first, b.first); }
+
+    private:
+        Compare comp;
+    };
+
+    FlatMultimap() = default;
+
+    explicit FlatMultimap(const Compare& comp) : comp(comp) {}
+
+    // Bulk build: one stable sort keeps equal keys in input order
+    template <typename InputIt>
+    FlatMultimap(InputIt first, InputIt last, const Compare& comp = Compare()) : elements(first, last), comp(comp) {
+        sortAndMerge(elements.begin());
+    }
+
+    FlatMultimap(std::initializer_list<value_type> init, const Compare& comp = Compare())
+        : FlatMultimap(init.begin(), init.end(), comp) {}
+
+    // Iterators
+    iterator begin() { return elements.begin(); }
+    iterator end() { return elements.end(); }
+    const_iterator begin() const { return elements.cbegin(); }
+    const_iterator end() const { return elements.cend(); }
+    const_iterator cbegin() const { return elements.cbegin(); }
+    const_iterator cend() const { return elements.cend(); }
+    reverse_iterator rbegin() { return elements.rbegin(); }
+    reverse_iterator rend() { return elements.rend(); }
+    const_reverse_iterator rbegin() const { return elements.crbegin(); }
+    const_reverse_iterator rend() const { return elements.crend(); }
+
+    // Capacity
+    bool empty() const { return elements.empty(); }
+    size_type size() const { return elements.size(); }
+    size_type capacity() const { return elements.capacity(); }
+    void reserve(size_type n) { elements.reserve(n); }
+    void shrink_to_fit() { elements.shrink_to_fit(); }
+
+    // Lookup
+    template <typename K>
+    iterator lower_bound(const K& key) {
+        return elements.begin() + (std::as_const(*this).lower_bound(key) - cbegin());
+    }
+
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        return branchlessLowerBound(elements.cbegin(), elements.cend(), key, keyLess());
+    }
+
+    template <typename K>
+    iterator upper_bound(const K& key) {
+        return elements.begin() + (std::as_const(*this).upper_bound(key) - cbegin());
+    }
+
+    template <typename K>
+    const_iterator upper_bound(const K& key) const {
+        return branchlessUpperBound(elements.cbegin(), elements.cend(), key, keyLess());
+    }
+
+    template <typename K>
+    std::pair<iterator, iterator> equal_range(const K& key) {
+        auto range = std::as_const(*this).equal_range(key);
+        return {elements.begin() + (range.first - cbegin()), elements.begin() + (range.second - cbegin())};
+    }
+
+    // The upper bound is searched only in the part after the lower bound
+    template <typename K>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        const_iterator first = lower_bound(key);
+        const_iterator last = branchlessUpperBound(first, elements.cend(), key, keyLess());
+        return {first, last};
+    }
+
+    template <typename K>
+    iterator find(const K& key) {
+        return elements.begin() + (std::as_const(*this).find(key) - cbegin());
+    }
+
+    // Returns the first element with the key, like std::multimap::find
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const_iterator it = lower_bound(key);
+        return (it != end() && !comp(key, it->first)) ? it : end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_type count(const K& key) const {
+        auto range = equal_range(key);
+        return static_cast<size_type>(range.second - range.first);
+    }
+
+    // Modifiers
+    iterator insert(const value_type& value) {
+        return emplace(value);
+    }
+
+    template <typename P>
+    iterator insert(P&& value) {
+        return emplace(std::forward<P>(value));
+    }
+
+    // Batched insert: append, sort only the new elements, then merge them in
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        size_type oldSize = elements.size();
+        elements.insert(elements.end(), first, last);
+        sortAndMerge(elements.begin() + oldSize);
+    }
+
+    void insert(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
+    // New elements go after the existing ones with the same key
+    template <typename... Args>
+    iterator emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        iterator pos = upper_bound(value.first);
+        return elements.insert(pos, std::move(value));
+    }
+
+    iterator erase(const_iterator pos) {
+        return elements.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return elements.erase(first, last);
+    }
+
+    // Erases all elements with the key and returns how many were removed
+    template <typename K, typename = std::enable_if_t<!std::is_convertible_v<const K&, const_iterator>>>
+    size_type erase(const K& key) {
+        auto range = std::as_const(*this).equal_range(key);
+        size_type erased = static_cast<size_type>(range.second - range.first);
+        elements.erase(range.first, range.second);
+        return erased;
+    }
+
+    void clear() {
+        elements.clear();
+    }
+
+    void swap(FlatMultimap& other) noexcept {
+        elements.swap(other.elements);
+        std::swap(comp, other.comp);
+    }
+
+    key_compare key_comp() const { return comp; }
+    value_compare value_comp() const { return value_compare(comp); }
+
+private:
+    // Compares an element with a bare key in either order, for the branchless searches
+    struct KeyLess {
+        const Compare& comp;
+
+        template <typename K>
+        bool operator()(const value_type& element, const K& key) const { return comp(element.first, key); }
+
+        template <typename K>
+        bool operator()(const K& key, const value_type& element) const { return comp(key, element.first); }
+
+        bool operator()(const value_type& a, const value_type& b) const { return comp(a.first, b.first); }
+    };
+
+    KeyLess keyLess() const {
+        return KeyLess{comp};
+    }
+
+    void sortAndMerge(iterator middle) {
+        std::stable_sort(middle, elements.end(), value_compare(comp));
+        std::inplace_merge(elements.begin(), middle, elements.end(), value_compare(comp));
+    }
+
+    std::vector<value_type> elements;
+    Compare comp;
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "Branchless_Search.h"
+
+// FlatSet: a sorted std::vector with the interface of std::set
+//
+// std::set allocates one tree node per element, so every comparison during a lookup
+// follows a pointer to a different place in memory. FlatSet keeps the elements sorted
+// in one contiguous array and looks them up with a branchless binary search. It is meant
+// for lookup tables that are built once and then mostly queried:
+//  - building from a range sorts once and then removes duplicates (O(n log n))
+//  - insert(first, last) sorts the new elements and merges them in one pass
+//  - a single insert or erase shifts the tail of the array (O(n)), unlike std::set
+//  - insert and erase invalidate iterators
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using iterator = typename std::vector<Key>::const_iterator;
+    using const_iterator = typename std::vector<Key>::const_iterator;
+    using reverse_iterator = typename std::vector<Key>::const_reverse_iterator;
+    using const_reverse_iterator = typename std::vector<Key>::const_reverse_iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp) : comp(comp) {}
+
+    // Bulk build: sort once, then drop duplicates
+    template <typename InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare()) : elements(first, last), comp(comp) {
+        sortAndUnique(elements.begin());
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare()) : FlatSet(init.begin(), init.end(), comp) {}
+
+    // Takes over an existing vector without copying it
+    explicit FlatSet(std::vector<Key> values, const Compare& comp = Compare()) : elements(std::move(values)), comp(comp) {
+        sortAndUnique(elements.begin());
+    }
+
+    // Iterators (elements cannot be modified in place, since that could break the order)
+    const_iterator begin() const { return elements.cbegin(); }
+    const_iterator end() const { return elements.cend(); }
+    const_iterator cbegin() const { return elements.cbegin(); }
+    const_iterator cend() const { return elements.cend(); }
+    const_reverse_iterator rbegin() const { return elements.crbegin(); }
+    const_reverse_iterator rend() const { return elements.crend(); }
+
+    // Capacity
+    bool empty() const { return elements.empty(); }
+    size_type size() const { return elements.size(); }
+    size_type capacity() const { return elements.capacity(); }
+    void reserve(size_type n) { elements.reserve(n); }
+    void shrink_to_fit() { elements.shrink_to_fit(); }
+
+    // The sorted elements as a plain vector
+    const std::vector<Key>& values() const { return elements; }
+
+    // Lookup
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        return branchlessLowerBound(elements.begin(), elements.end(), key, comp);
+    }
+
+    template <typename K>
+    const_iterator upper_bound(const K& key) const {
+        return branchlessUpperBound(elements.begin(), elements.end(), key, comp);
+    }
+
+    template <typename K>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        const_iterator first = lower_bound(key);
+        // Keys are unique, so the range holds at most one element
+        const_iterator last = (first != end() && !comp(key, *first)) ? first + 1 : first;
+        return {first, last};
+    }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const_iterator it = lower_bound(key);
+        return (it != end() && !comp(key, *it)) ? it : end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Modifiers
+    std::pair<iterator, bool> insert(const Key& key) {
+        return emplace(key);
+    }
+
+    std::pair<iterator, bool> insert(Key&& key) {
+        return emplace(std::move(key));
+    }
+
+    // Batched insert: append, sort only the new elements, then merge them in
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        size_type oldSize = elements.size();
+        elements.insert(elements.end(), first, last);
+        sortAndUnique(elements.begin() + oldSize);
+    }
+
+    void insert(std::initializer_list<Key> init) {
+        insert(init.begin(), init.end());
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        Key key(std::forward<Args>(args)...);
+        auto it = elements.begin() + (lower_bound(key) - begin());
+        if (it != elements.end() && !comp(key, *it)) {
+            return {it, false};
+        }
+        return {elements.insert(it, std::move(key)), true};
+    }
+
+    iterator erase(const_iterator pos) {
+        return elements.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return elements.erase(first, last);
+    }
+
+    size_type erase(const Key& key) {
+        auto range = equal_range(key);
+        size_type erased = static_cast<size_type>(range.second - range.first);
+        elements.erase(range.first, range.second);
+        return erased;
+    }
+
+    void clear() {
+        elements.clear();
+    }
+
+    void swap(FlatSet& other) noexcept {
+        elements.swap(other.elements);
+        std::swap(comp, other.comp);
+    }
+
+    key_compare key_comp() const { return comp; }
+
+private:
+    // Sorts [middle, end), merges it with the already sorted [begin, middle) and removes
+    // duplicates. Stable sorting keeps the first inserted of several equivalent elements,
+    // which matches what repeated std::set::insert calls would keep.
+    void sortAndUnique(typename std::vector<Key>::iterator middle) {
+        std::stable_sort(middle, elements.end(), comp);
+        std::inplace_merge(elements.begin(), middle, elements.end(), comp);
+        auto equivalent = [this](const Key& a, const Key& b) { return !comp(a, b) && !comp(b, a); };
+        elements.erase(std::unique(elements.begin(), elements.end(), equivalent), elements.end());
+    }
+
+    std::vector<Key> elements;
+    Compare comp;
+};
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Lazy pipelines that run chained element-wise steps in a single pass
+//
+// Algorithms.cpp and Lambda.cpp make one pass over the vector per step (increment, search,
+// multiply, ...), so a large vector is streamed from memory once per step. A pipeline
+// describes the steps first and runs them together when a terminal step asks for a result:
+//     std::optional<int> hit = from(vec)
+//                            | transform([](int n) { return n + 1; })
+//                            | filter([](int n) { return n % 2 == 0; })
+//                            | findFirst([](int n) { return n > 5; });
+// Every element goes through transform, filter and findFirst before the next one is read,
+// and the loop stops at the first match, so nothing after it is touched at all.
+//
+// Element-wise steps:  transform(f), filter(pred), takeWhile(pred)
+// Materializing step:  sorted() / sorted(comp) collects the elements into a vector and sorts
+//                      them; the steps before and the steps after it each fuse into one pass
+// Terminal steps:      findFirst(pred) -> std::optional, toVector(), forEach(f)
+//
+// Nothing runs until a terminal step (or sorted()) is applied. from(range) keeps a reference
+// to the range, so the range has to outlive the pipeline.
+
+// A pipeline producing elements of type T. run(sink) calls sink(element) for each element in
+// order until sink returns false, and returns false if it was stopped that way.
+// knownSize is the exact number of elements when no step can drop any, so that toVector()
+// can allocate once.
+template <typename T, typename Run>
+class Pipeline {
+public:
+    using value_type = T;
+
+    Pipeline(Run run, std::optional<std::size_t> knownSize) : run(std::move(run)), knownSize(knownSize) {}
+
+    template <typename Sink>
+    bool operator()(Sink&& sink) const {
+        return run(sink);
+    }
+
+    std::optional<std::size_t> size() const {
+        return knownSize;
+    }
+
+private:
+    Run run;
+    std::optional<std::size_t> knownSize;
+};
+
+template <typename T, typename Run>
+Pipeline<T, Run> makePipeline(Run run, std::optional<std::size_t> knownSize) {
+    return Pipeline<T, Run>(std::move(run), knownSize);
+}
+
+// Pipeline over the elements of a container or any range that works with a range-for
+template <typename Range>
+auto from(const Range& range) {
+    using T = std::decay_t<decltype(*std::begin(range))>;
+    const auto size = std::distance(std::begin(range), std::end(range));
+    return makePipeline<T>(
+        [&range](auto& sink) {
+            for (const auto& element : range) {
+                if (!sink(element)) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        static_cast<std::size_t>(size));
+}
+
+// A pipeline over a temporary would outlive it
+template <typename Range>
+void from(const Range&& range) = delete;
+
+// Step descriptions; applying them to a pipeline with | builds the fused loop
+
+template <typename F>
+struct TransformStep {
+    F fn;
+};
+
+template <typename Pred>
+struct FilterStep {
+    Pred pred;
+};
+
+template <typename Pred>
+struct TakeWhileStep {
+    Pred pred;
+};
+
+template <typename Compare>
+struct SortedStep {
+    Compare comp;
+};
+
+template <typename Pred>
+struct FindFirstStep {
+    Pred pred;
+};
+
+struct ToVectorStep {};
+
+template <typename F>
+struct ForEachStep {
+    F fn;
+};
+
+// Replaces every element x by fn(x)
+template <typename F>
+TransformStep<F> transform(F fn) {
+    return {std::move(fn)};
+}
+
+// Keeps the elements for which pred is true
+template <typename Pred>
+FilterStep<Pred> filter(Pred pred) {
+    return {std::move(pred)};
+}
+
+// Keeps elements while pred is true and ends the pass at the first one for which it is false
+template <typename Pred>
+TakeWhileStep<Pred> takeWhile(Pred pred) {
+    return {std::move(pred)};
+}
+
+// Sorts all elements (std::sort with comp); this is the only step that needs them all at once
+template <typename Compare = std::less<>>
+SortedStep<Compare> sorted(Compare comp = Compare()) {
+    return {std::move(comp)};
+}
+
+// First element for which pred is true, or std::nullopt
+template <typename Pred>
+FindFirstStep<Pred> findFirst(Pred pred) {
+    return {std::move(pred)};
+}
+
+// All elements in a std::vector
+inline ToVectorStep toVector() {
+    return {};
+}
+
+// Calls fn on every element
+template <typename F>
+ForEachStep<F> forEach(F fn) {
+    return {std::move(fn)};
+}
+
+template <typename T, typename Run, typename F>
+auto operator|(Pipeline<T, Run> source, TransformStep<F> step) {
+    using U = std::decay_t<std::invoke_result_t<F&, const T&>>;
+    const auto size = source.size();
+    return makePipeline<U>(
+        [source = std::move(source), fn = std::move(step.fn)](auto& sink) {
+            auto next = [&](const auto& element) { return sink(fn(element)); };
+            return source(next);
+        },
+        size);
+}
+
+template <typename T, typename Run, typename Pred>
+auto operator|(Pipeline<T, Run> source, FilterStep<Pred> step) {
+    return makePipeline<T>(
+        [source = std::move(source), pred = std::move(step.pred)](auto& sink) {
+            auto next = [&](const auto& element) { return pred(element) ? sink(element) : true; };
+            return source(next);
+        },
+        std::nullopt);
+}
+
+template <typename T, typename Run, typename Pred>
+auto operator|(Pipeline<T, Run> source, TakeWhileStep<Pred> step) {
+    return makePipeline<T>(
+        [source = std::move(source), pred = std::move(step.pred)](auto& sink) {
+            bool taking = true;
+            auto next = [&](const auto& element) {
+                taking = pred(element);
+                return taking && sink(element);
+            };
+            // Stopping at the end of the taken prefix is not a stop requested by the sink
+            return source(next) || !taking;
+        },
+        std::nullopt);
+}
+
+template <typename T, typename Run>
+std::vector<T> operator|(const Pipeline<T, Run>& source, ToVectorStep) {
+    std::vector<T> result;
+    if (source.size()) {
+        result.reserve(*source.size());
+    }
+    auto next = [&](const auto& element) {
+        result.push_back(element);
+        return true;
+    };
+    source(next);
+    return result;
+}
+
+// Runs the pipeline so far and continues from the sorted vector, which the new pipeline owns
+template <typename T, typename Run, typename Compare>
+auto operator|(const Pipeline<T, Run>& source, SortedStep<Compare> step) {
+    std::vector<T> values = source | toVector();
+    std::sort(values.begin(), values.end(), step.comp);
+    const std::size_t size = values.size();
+    return makePipeline<T>(
+        [values = std::move(values)](auto& sink) {
+            for (const T& element : values) {
+                if (!sink(element)) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        size);
+}
+
+template <typename T, typename Run, typename Pred>
+std::optional<T> operator|(const Pipeline<T, Run>& source, FindFirstStep<Pred> step) {
+    std::optional<T> found;
+    auto next = [&](const auto& element) {
+        if (step.pred(element)) {
+            found = element;
+            return false;
+        }
+        return true;
+    };
+    source(next);
+    return found;
+}
+
+template <typename T, typename Run, typename F>
+void operator|(const Pipeline<T, Run>& source, ForEachStep<F> step) {
+    auto next = [&](const auto& element) {
+        step.fn(element);
+        return true;
+    };
+    source(next);
+}
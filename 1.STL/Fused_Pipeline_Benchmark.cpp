@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Fused_Pipeline.h"
+
+// Compares step-by-step std algorithms with the fused pipelines of Fused_Pipeline.h on a
+// large vector of random ints, for three chains taken from Algorithms.cpp and Lambda.cpp:
+//
+//   increment + find:         for_each(n++), find_if(n > limit)
+//   increment + sort + double: copy, for_each(n++), sort, for_each(n *= 2)
+//   transform + filter + take: transform(n++) into a temporary, copy_if(even),
+//                              then the prefix before the first value above a limit
+//
+// "Passes" counts the full reads of the data outside of sort; the fused versions need one
+// pass per run of element-wise steps. In the second chain the sort itself takes most of the
+// time, so the saved pass shows up as a small difference there.
+// Every fused result is compared with the std one; any difference makes the program exit
+// with status 1.
+//
+// Usage: Fused_Pipeline_Benchmark [elements]   (default: 50000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    const int repeats = 3;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, 1000000);
+    std::vector<int> data(elements);
+    for (int& value : data) {
+        value = dis(gen);
+    }
+    // The searched-for value only occurs at 3/4 of the way in
+    const int limit = 1000001;
+    if (elements > 0) {
+        data[elements * 3 / 4] = limit;
+    }
+    auto increment = [](int n) { return n + 1; };
+    auto twice = [](int n) { return n * 2; };
+    auto even = [](int n) { return n % 2 == 0; };
+    auto aboveLimit = [limit](int n) { return n > limit; };
+    auto notAboveLimit = [limit](int n) { return n <= limit; };
+
+    bool ok = true;
+    std::cout << "Elements: " << elements << std::endl;
+    std::cout << std::left << std::setw(28) << "chain" << std::right << std::setw(12) << "std" << std::setw(8)
+              << "passes" << std::setw(12) << "fused" << std::setw(8) << "passes" << std::setw(10) << "speedup"
+              << std::endl;
+    auto report = [](const char* chain, double stdTime, int stdPasses, double fusedTime, int fusedPasses) {
+        std::cout << std::left << std::setw(28) << chain << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << stdTime * 1e3 << " ms" << std::setw(8) << stdPasses << std::setw(9)
+                  << fusedTime * 1e3 << " ms" << std::setw(8) << fusedPasses << std::setw(9) << std::setprecision(2)
+                  << stdTime / fusedTime << "x" << std::endl;
+    };
+
+    // 1. Increment every element, then find the first one above the limit
+    std::vector<int> work;
+    std::optional<int> stdHit;
+    double stdTime = measureSeconds(repeats, [&] {
+        work = data;
+        std::for_each(work.begin(), work.end(), [](int& n) { n++; });
+        auto it = std::find_if(work.begin(), work.end(), aboveLimit);
+        stdHit = it != work.end() ? std::optional<int>(*it) : std::nullopt;
+        doNotOptimize(stdHit);
+    });
+    std::optional<int> fusedHit;
+    double fusedTime = measureSeconds(repeats, [&] {
+        fusedHit = from(data) | transform(increment) | findFirst(aboveLimit);
+        doNotOptimize(fusedHit);
+    });
+    ok = ok && stdHit == fusedHit;
+    report("increment + find", stdTime, 3, fusedTime, 1);
+
+    // 2. Increment, sort, then double every element
+    std::vector<int> stdSorted;
+    stdTime = measureSeconds(repeats, [&] {
+        stdSorted = data;
+        std::for_each(stdSorted.begin(), stdSorted.end(), [](int& n) { n++; });
+        std::sort(stdSorted.begin(), stdSorted.end());
+        std::for_each(stdSorted.begin(), stdSorted.end(), [](int& n) { n *= 2; });
+        doNotOptimize(stdSorted.data());
+    });
+    std::vector<int> fusedSorted;
+    fusedTime = measureSeconds(repeats, [&] {
+        fusedSorted = from(data) | transform(increment) | sorted() | transform(twice) | toVector();
+        doNotOptimize(fusedSorted.data());
+    });
+    ok = ok && stdSorted == fusedSorted;
+    report("increment + sort + double", stdTime, 3, fusedTime, 2);
+
+    // 3. Increment, keep the even values, stop at the first value above the limit
+    std::vector<int> stdKept;
+    stdTime = measureSeconds(repeats, [&] {
+        std::vector<int> incremented(data.size());
+        std::transform(data.begin(), data.end(), incremented.begin(), increment);
+        std::vector<int> evens;
+        std::copy_if(incremented.begin(), incremented.end(), std::back_inserter(evens), even);
+        evens.erase(std::find_if(evens.begin(), evens.end(), aboveLimit), evens.end());
+        stdKept = std::move(evens);
+        doNotOptimize(stdKept.data());
+    });
+    std::vector<int> fusedKept;
+    fusedTime = measureSeconds(repeats, [&] {
+        fusedKept = from(data) | transform(increment) | filter(even) | takeWhile(notAboveLimit) | toVector();
+        doNotOptimize(fusedKept.data());
+    });
+    ok = ok && stdKept == fusedKept;
+    report("transform + filter + take", stdTime, 3, fusedTime, 1);
+
+    std::cout << (ok ? "All fused results match the std ones." : "Fused results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
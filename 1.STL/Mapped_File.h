@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// How a mapping will be read, passed on to the OS as a read-ahead hint
+// (madvise on POSIX, the file flags of CreateFile on Windows)
+enum class MappedFileAccess {
+    Normal,     // no hint
+    Sequential, // one pass from start to end: read ahead aggressively
+    Random      // jumps around: do not read ahead
+};
+
+// A read-only memory mapping of a whole file
+//
+// The bytes are read in place: pages are loaded by the OS as they are touched, and nothing
+// is copied into the process. Used by Person_Snapshot.h and Word_Tokenizer.h.
+// Files larger than the address space (over 2 GB in a 32-bit build) cannot be mapped.
+// Throws std::runtime_error if the file cannot be opened or mapped; an empty file gives
+// an empty mapping (data() is nullptr).
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path, MappedFileAccess access = MappedFileAccess::Normal) {
+        map(path, access);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : bytes(std::exchange(other.bytes, nullptr)), fileSize(std::exchange(other.fileSize, 0)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            bytes = std::exchange(other.bytes, nullptr);
+            fileSize = std::exchange(other.fileSize, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return fileSize; }
+    bool empty() const { return fileSize == 0; }
+
+    // The whole file as characters
+    std::string_view text() const {
+        return std::string_view(reinterpret_cast<const char*>(bytes), fileSize);
+    }
+
+private:
+#ifdef _WIN32
+    void map(const std::string& path, MappedFileAccess access) {
+        const DWORD flags = access == MappedFileAccess::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                            : access == MappedFileAccess::Random   ? FILE_FLAG_RANDOM_ACCESS
+                                                                   : FILE_ATTRIBUTE_NORMAL;
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: cannot read " + path);
+        }
+        if (static_cast<unsigned long long>(size.QuadPart) > static_cast<std::size_t>(-1)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: too large to map " + path);
+        }
+        fileSize = static_cast<std::size_t>(size.QuadPart);
+        if (fileSize == 0) {
+            CloseHandle(file);
+            return;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            throw std::runtime_error("MappedFile: cannot map " + path);
+        }
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping); // The view keeps the mapping alive
+        if (bytes == nullptr) {
+            throw std::runtime_error("MappedFile: cannot map " + path);
+        }
+    }
+
+    void unmap() {
+        if (bytes != nullptr) {
+            UnmapViewOfFile(bytes);
+            bytes = nullptr;
+        }
+    }
+#else
+    void map(const std::string& path, MappedFileAccess access) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot read " + path);
+        }
+        if (static_cast<unsigned long long>(info.st_size) > static_cast<std::size_t>(-1)) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: too large to map " + path);
+        }
+        fileSize = static_cast<std::size_t>(info.st_size);
+        if (fileSize == 0) {
+            ::close(fd);
+            return;
+        }
+        void* mapped = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (mapped == MAP_FAILED) {
+            fileSize = 0;
+            throw std::runtime_error("MappedFile: cannot map " + path);
+        }
+        if (access != MappedFileAccess::Normal) {
+            ::madvise(mapped, fileSize, access == MappedFileAccess::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        }
+        bytes = static_cast<const unsigned char*>(mapped);
+    }
+
+    void unmap() {
+        if (bytes != nullptr) {
+            ::munmap(const_cast<unsigned char*>(bytes), fileSize);
+            bytes = nullptr;
+        }
+    }
+#endif
+
+    const unsigned char* bytes = nullptr;
+    std::size_t fileSize = 0;
+};
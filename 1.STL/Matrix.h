@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Simd_Kernels.h"
+#include "Thread_Pool.h"
+
+// Matrix<T>: a dense matrix in one contiguous row-major buffer
+//
+// A std::vector<std::vector<int>> allocates every row separately and reaches an element
+// through two pointers, so the rows end up scattered over the heap and a loop over the
+// matrix cannot be vectorized across rows. Matrix keeps rows * cols elements in one vector:
+//     Matrix<int> a = {{1, 2}, {3, 4}};
+//     Matrix<int> b(2, 2, 1);                  // 2x2, every element 1
+//     Matrix<int> sum = a + b;                 // element-wise
+//     Matrix<int> product = a * b;             // blocked, SIMD
+//     Matrix<int> big = multiply(pool, x, y);  // the same, split over a ThreadPool
+//     a[1][0] = 5;                             // a[row] is a pointer to the row
+// Operations on matrices whose dimensions do not fit throw std::invalid_argument.
+//
+// The multiply works on blocks of kMatrixBlockRows x kMatrixBlockDepth of the left matrix
+// against kMatrixBlockDepth x kMatrixBlockCols of the right one, so the block of the right
+// matrix stays in the L2 cache while every row of the left block goes over it, instead of
+// the whole right matrix being streamed from memory once per row. Inside a block, the AVX2
+// kernel keeps a 4 x 16 (4 x 8 for double) tile of the result in registers for the whole
+// depth: each step loads two vectors of a row of the right matrix, broadcasts 4 elements
+// of the left one and does 8 multiply-adds. The parallel version hands out horizontal
+// strips of the result, so no two threads write the same element.
+//
+// Explicit kernels exist for int, float and double; other element types, and the SSE2
+// level, use the scalar kernel, whose inner loop runs along a contiguous row and is
+// vectorized by the compiler. The AVX2 kernels multiply and add separately instead of
+// using FMA and sum in the same order as the scalar kernel, so float and double results
+// are the same at every level.
+
+// Block sizes of the multiply, in elements
+constexpr std::size_t kMatrixBlockRows = 64;
+constexpr std::size_t kMatrixBlockDepth = 256;
+constexpr std::size_t kMatrixBlockCols = 256;
+
+template <typename T>
+class Matrix {
+public:
+    Matrix() = default;
+
+    Matrix(std::size_t rows, std::size_t cols, const T& value = T())
+        : rowCount(rows), colCount(cols), elements(rows * cols, value) {}
+
+    // Rows given as lists, like the nested-vector initializer; they must all have the same length
+    Matrix(std::initializer_list<std::initializer_list<T>> rows)
+        : rowCount(rows.size()), colCount(rows.size() == 0 ? 0 : rows.begin()->size()) {
+        elements.reserve(rowCount * colCount);
+        for (const auto& row : rows) {
+            if (row.size() != colCount) {
+                throw std::invalid_argument("Matrix: rows of different lengths");
+            }
+            elements.insert(elements.end(), row.begin(), row.end());
+        }
+    }
+
+    std::size_t rows() const {
+        return rowCount;
+    }
+
+    std::size_t cols() const {
+        return colCount;
+    }
+
+    bool empty() const {
+        return elements.empty();
+    }
+
+    T& operator()(std::size_t row, std::size_t col) {
+        return elements[row * colCount + col];
+    }
+
+    const T& operator()(std::size_t row, std::size_t col) const {
+        return elements[row * colCount + col];
+    }
+
+    // Start of a row, so that m[row][col] works as with nested vectors
+    T* operator[](std::size_t row) {
+        return elements.data() + row * colCount;
+    }
+
+    const T* operator[](std::size_t row) const {
+        return elements.data() + row * colCount;
+    }
+
+    T* data() {
+        return elements.data();
+    }
+
+    const T* data() const {
+        return elements.data();
+    }
+
+    Matrix& operator+=(const Matrix& other) {
+        if (rowCount != other.rowCount || colCount != other.colCount) {
+            throw std::invalid_argument("Matrix: adding matrices of different sizes");
+        }
+        T* out = elements.data();
+        const T* in = other.elements.data();
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            out[i] += in[i];
+        }
+        return *this;
+    }
+
+    friend Matrix operator+(Matrix left, const Matrix& right) {
+        left += right;
+        return left;
+    }
+
+    friend bool operator==(const Matrix& left, const Matrix& right) {
+        return left.rowCount == right.rowCount && left.colCount == right.colCount && left.elements == right.elements;
+    }
+
+    friend bool operator!=(const Matrix& left, const Matrix& right) {
+        return !(left == right);
+    }
+
+    // One line per row, elements separated by spaces
+    friend std::ostream& operator<<(std::ostream& out, const Matrix& matrix) {
+        for (std::size_t row = 0; row < matrix.rowCount; ++row) {
+            for (std::size_t col = 0; col < matrix.colCount; ++col) {
+                out << matrix(row, col) << " ";
+            }
+            out << "\n";
+        }
+        return out;
+    }
+
+private:
+    std::size_t rowCount = 0;
+    std::size_t colCount = 0;
+    std::vector<T> elements;
+};
+
+// One implementation of the inner multiply kernel:
+// c[rows x cols] += a[rows x depth] * b[depth x cols], where each stride is the distance
+// between two rows of that matrix
+template <typename T>
+struct MatrixKernels {
+    void (*multiplyAdd)(const T* a, std::size_t aStride, const T* b, std::size_t bStride, T* c, std::size_t cStride,
+                        std::size_t rows, std::size_t depth, std::size_t cols);
+};
+
+template <typename T>
+void scalarMatrixMultiplyAdd(const T* a, std::size_t aStride, const T* b, std::size_t bStride, T* c,
+                             std::size_t cStride, std::size_t rows, std::size_t depth, std::size_t cols) {
+    for (std::size_t i = 0; i < rows; ++i) {
+        T* cRow = c + i * cStride;
+        for (std::size_t k = 0; k < depth; ++k) {
+            const T x = a[i * aStride + k];
+            const T* bRow = b + k * bStride;
+            for (std::size_t j = 0; j < cols; ++j) {
+                cRow[j] += x * bRow[j];
+            }
+        }
+    }
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// AVX2 operations on one element type, used by avx2MatrixMultiplyAdd
+struct Avx2IntOps {
+    using Value = int;
+    using Vector = __m256i;
+    static constexpr std::size_t kWidth = 8;
+
+    SIMD_TARGET_AVX2 static Vector load(const int* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    SIMD_TARGET_AVX2 static void store(int* p, Vector v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    SIMD_TARGET_AVX2 static Vector broadcast(int x) {
+        return _mm256_set1_epi32(x);
+    }
+    SIMD_TARGET_AVX2 static Vector multiplyAdd(Vector sum, Vector x, Vector y) {
+        return _mm256_add_epi32(sum, _mm256_mullo_epi32(x, y));
+    }
+};
+
+struct Avx2FloatOps {
+    using Value = float;
+    using Vector = __m256;
+    static constexpr std::size_t kWidth = 8;
+
+    SIMD_TARGET_AVX2 static Vector load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+    SIMD_TARGET_AVX2 static void store(float* p, Vector v) {
+        _mm256_storeu_ps(p, v);
+    }
+    SIMD_TARGET_AVX2 static Vector broadcast(float x) {
+        return _mm256_set1_ps(x);
+    }
+    SIMD_TARGET_AVX2 static Vector multiplyAdd(Vector sum, Vector x, Vector y) {
+        return _mm256_add_ps(sum, _mm256_mul_ps(x, y));
+    }
+};
+
+struct Avx2DoubleOps {
+    using Value = double;
+    using Vector = __m256d;
+    static constexpr std::size_t kWidth = 4;
+
+    SIMD_TARGET_AVX2 static Vector load(const double* p) {
+        return _mm256_loadu_pd(p);
+    }
+    SIMD_TARGET_AVX2 static void store(double* p, Vector v) {
+        _mm256_storeu_pd(p, v);
+    }
+    SIMD_TARGET_AVX2 static Vector broadcast(double x) {
+        return _mm256_set1_pd(x);
+    }
+    SIMD_TARGET_AVX2 static Vector multiplyAdd(Vector sum, Vector x, Vector y) {
+        return _mm256_add_pd(sum, _mm256_mul_pd(x, y));
+    }
+};
+
+// The AVX2 operations on T, or void if T has no AVX2 kernel
+template <typename T>
+struct Avx2MatrixOps {
+    using type = void;
+};
+
+template <>
+struct Avx2MatrixOps<int> {
+    using type = Avx2IntOps;
+};
+
+template <>
+struct Avx2MatrixOps<float> {
+    using type = Avx2FloatOps;
+};
+
+template <>
+struct Avx2MatrixOps<double> {
+    using type = Avx2DoubleOps;
+};
+
+// Tiles of 4 rows x 2 vectors stay in registers over the whole depth; leftover rows are
+// done one at a time with the same two vectors, and leftover columns by the scalar kernel
+template <typename Ops>
+SIMD_TARGET_AVX2 void avx2MatrixMultiplyAdd(const typename Ops::Value* a, std::size_t aStride,
+                                            const typename Ops::Value* b, std::size_t bStride,
+                                            typename Ops::Value* c, std::size_t cStride, std::size_t rows,
+                                            std::size_t depth, std::size_t cols) {
+    using Vector = typename Ops::Vector;
+    constexpr std::size_t kWidth = Ops::kWidth;
+    std::size_t j = 0;
+    for (; j + 2 * kWidth <= cols; j += 2 * kWidth) {
+        std::size_t i = 0;
+        for (; i + 4 <= rows; i += 4) {
+            typename Ops::Value* c0 = c + i * cStride + j;
+            typename Ops::Value* c1 = c0 + cStride;
+            typename Ops::Value* c2 = c1 + cStride;
+            typename Ops::Value* c3 = c2 + cStride;
+            Vector s00 = Ops::load(c0), s01 = Ops::load(c0 + kWidth);
+            Vector s10 = Ops::load(c1), s11 = Ops::load(c1 + kWidth);
+            Vector s20 = Ops::load(c2), s21 = Ops::load(c2 + kWidth);
+            Vector s30 = Ops::load(c3), s31 = Ops::load(c3 + kWidth);
+            const typename Ops::Value* aRow = a + i * aStride;
+            for (std::size_t k = 0; k < depth; ++k) {
+                const Vector b0 = Ops::load(b + k * bStride + j);
+                const Vector b1 = Ops::load(b + k * bStride + j + kWidth);
+                Vector x = Ops::broadcast(aRow[k]);
+                s00 = Ops::multiplyAdd(s00, x, b0);
+                s01 = Ops::multiplyAdd(s01, x, b1);
+                x = Ops::broadcast(aRow[aStride + k]);
+                s10 = Ops::multiplyAdd(s10, x, b0);
+                s11 = Ops::multiplyAdd(s11, x, b1);
+                x = Ops::broadcast(aRow[2 * aStride + k]);
+                s20 = Ops::multiplyAdd(s20, x, b0);
+                s21 = Ops::multiplyAdd(s21, x, b1);
+                x = Ops::broadcast(aRow[3 * aStride + k]);
+                s30 = Ops::multiplyAdd(s30, x, b0);
+                s31 = Ops::multiplyAdd(s31, x, b1);
+            }
+            Ops::store(c0, s00), Ops::store(c0 + kWidth, s01);
+            Ops::store(c1, s10), Ops::store(c1 + kWidth, s11);
+            Ops::store(c2, s20), Ops::store(c2 + kWidth, s21);
+            Ops::store(c3, s30), Ops::store(c3 + kWidth, s31);
+        }
+        for (; i < rows; ++i) {
+            typename Ops::Value* cRow = c + i * cStride + j;
+            Vector s0 = Ops::load(cRow), s1 = Ops::load(cRow + kWidth);
+            for (std::size_t k = 0; k < depth; ++k) {
+                const Vector x = Ops::broadcast(a[i * aStride + k]);
+                s0 = Ops::multiplyAdd(s0, x, Ops::load(b + k * bStride + j));
+                s1 = Ops::multiplyAdd(s1, x, Ops::load(b + k * bStride + j + kWidth));
+            }
+            Ops::store(cRow, s0);
+            Ops::store(cRow + kWidth, s1);
+        }
+    }
+    scalarMatrixMultiplyAdd(a, aStride, b + j, bStride, c + j, cStride, rows, depth, cols - j);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Multiply kernel of a level; there is no SSE2 kernel, SSE2 machines get the scalar loop
+template <typename T>
+const MatrixKernels<T>& matrixKernels(SimdLevel level) {
+    static const MatrixKernels<T> scalar = {scalarMatrixMultiplyAdd<T>};
+#ifdef SIMD_KERNELS_X86
+    using Ops = typename Avx2MatrixOps<T>::type;
+    if constexpr (!std::is_void_v<Ops>) {
+        static const MatrixKernels<T> avx2 = {avx2MatrixMultiplyAdd<Ops>};
+        return kernelsForLevel(level, scalar, scalar, avx2);
+    }
+#endif
+    return kernelsForLevel(level, scalar);
+}
+
+template <typename T>
+const MatrixKernels<T>& matrixKernels() {
+    static const MatrixKernels<T>& kernels = matrixKernels<T>(simdLevel());
+    return kernels;
+}
+
+// result[rowBegin, rowEnd) += the same rows of left * right, block by block
+template <typename T>
+void multiplyRows(const MatrixKernels<T>& kernels, const Matrix<T>& left, const Matrix<T>& right,
+                  Matrix<T>& result, std::size_t rowBegin, std::size_t rowEnd) {
+    const std::size_t depth = left.cols();
+    const std::size_t cols = right.cols();
+    for (std::size_t j = 0; j < cols; j += kMatrixBlockCols) {
+        const std::size_t blockCols = std::min(kMatrixBlockCols, cols - j);
+        for (std::size_t k = 0; k < depth; k += kMatrixBlockDepth) {
+            const std::size_t blockDepth = std::min(kMatrixBlockDepth, depth - k);
+            for (std::size_t i = rowBegin; i < rowEnd; i += kMatrixBlockRows) {
+                const std::size_t blockRows = std::min(kMatrixBlockRows, rowEnd - i);
+                kernels.multiplyAdd(left[i] + k, depth, right[k] + j, cols, result[i] + j, cols, blockRows,
+                                    blockDepth, blockCols);
+            }
+        }
+    }
+}
+
+template <typename T>
+void checkMultiplySizes(const Matrix<T>& left, const Matrix<T>& right) {
+    if (left.cols() != right.rows()) {
+        throw std::invalid_argument("Matrix: multiplying matrices of incompatible sizes");
+    }
+}
+
+// left * right with the given kernels
+template <typename T>
+Matrix<T> multiply(const Matrix<T>& left, const Matrix<T>& right, const MatrixKernels<T>& kernels) {
+    checkMultiplySizes(left, right);
+    Matrix<T> result(left.rows(), right.cols());
+    multiplyRows(kernels, left, right, result, 0, left.rows());
+    return result;
+}
+
+template <typename T>
+Matrix<T> multiply(const Matrix<T>& left, const Matrix<T>& right) {
+    return multiply(left, right, matrixKernels<T>());
+}
+
+// left * right with strips of kMatrixBlockRows rows of the result handed out to the pool.
+// Products with a single strip, or with a right matrix smaller than one block, run on the
+// calling thread, because waking the workers would cost more than they save.
+template <typename T>
+Matrix<T> multiply(ThreadPool& pool, const Matrix<T>& left, const Matrix<T>& right,
+                   const MatrixKernels<T>& kernels = matrixKernels<T>()) {
+    checkMultiplySizes(left, right);
+    Matrix<T> result(left.rows(), right.cols());
+    const std::size_t strips = (left.rows() + kMatrixBlockRows - 1) / kMatrixBlockRows;
+    if (strips <= 1 || left.cols() * right.cols() < kMatrixBlockDepth * kMatrixBlockCols) {
+        multiplyRows(kernels, left, right, result, 0, left.rows());
+        return result;
+    }
+    pool.run(strips, [&](std::size_t strip) {
+        multiplyRows(kernels, left, right, result, strip * kMatrixBlockRows,
+                     std::min(left.rows(), (strip + 1) * kMatrixBlockRows));
+    });
+    return result;
+}
+
+template <typename T>
+Matrix<T> operator*(const Matrix<T>& left, const Matrix<T>& right) {
+    return multiply(left, right);
+}
@@ -0,0 +1,219 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Matrix.h"
+
+// Compares the std::vector<std::vector<int>> matrices of More_Topics.cpp with Matrix<int> on
+// square matrices from 2x2 up to maxSize x maxSize (doubling each time):
+//   - element-wise add: the nested index loop against Matrix::operator+
+//   - multiply: the textbook i-j-k loop on nested vectors against the blocked multiply with
+//     the kernels of every SIMD level this machine supports, and against the parallel
+//     multiply on a ThreadPool with all hardware threads
+// Small sizes repeat each operation enough times to be measurable. The textbook multiply
+// takes minutes beyond 1024x1024, so there it only computes the first rows and its time is
+// scaled up, and the scalar kernel is only timed up to 1024x1024.
+// Every result is compared with the nested-vector one (element by element, or on the
+// computed rows), and the float and double kernels are checked on sizes that are not
+// multiples of the tile; any difference is reported and makes the program exit with status 1.
+//
+// Usage: Matrix_Benchmark [maxSize] [threads]
+//        (defaults: 4096 and std::thread::hardware_concurrency())
+// Build with optimizations and threads, e.g. g++ -std=c++17 -O3 -pthread
+
+namespace {
+
+using NestedMatrix = std::vector<std::vector<int>>;
+
+NestedMatrix nestedAdd(const NestedMatrix& a, const NestedMatrix& b) {
+    const std::size_t n = a.size();
+    NestedMatrix sum(n, std::vector<int>(n));
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            sum[i][j] = a[i][j] + b[i][j];
+        }
+    }
+    return sum;
+}
+
+// The first `rows` rows of a * b
+NestedMatrix nestedMultiply(const NestedMatrix& a, const NestedMatrix& b, std::size_t rows) {
+    const std::size_t n = a.size();
+    NestedMatrix product(rows, std::vector<int>(n));
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            int sum = 0;
+            for (std::size_t k = 0; k < n; ++k) {
+                sum += a[i][k] * b[k][j];
+            }
+            product[i][j] = sum;
+        }
+    }
+    return product;
+}
+
+// Microseconds, followed by the speedup over baseline unless baseline is 0
+void printTime(double seconds, double baseline) {
+    std::cout << std::fixed << std::setprecision(3) << std::setw(baseline > 0 ? 13 : 15) << seconds * 1e6;
+    if (baseline > 0) {
+        std::cout << " (" << std::setprecision(1) << std::setw(5) << baseline / seconds << "x)";
+    }
+}
+
+// True if the first rows of matrix hold the same values as nested
+bool sameRows(const Matrix<int>& matrix, const NestedMatrix& nested) {
+    for (std::size_t i = 0; i < nested.size(); ++i) {
+        for (std::size_t j = 0; j < nested[i].size(); ++j) {
+            if (matrix[i][j] != nested[i][j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Multiplies two matrices of the given shape with small integer values, which floats and
+// doubles hold exactly, with every kernel and compares with the scalar result
+template <typename T>
+bool kernelsAgree(const std::vector<SimdLevel>& levels, ThreadPool& pool, std::size_t rows, std::size_t depth,
+                  std::size_t cols, std::mt19937& gen) {
+    std::uniform_int_distribution<int> value(-9, 9);
+    Matrix<T> a(rows, depth);
+    Matrix<T> b(depth, cols);
+    for (std::size_t i = 0; i < rows * depth; ++i) {
+        a.data()[i] = static_cast<T>(value(gen));
+    }
+    for (std::size_t i = 0; i < depth * cols; ++i) {
+        b.data()[i] = static_cast<T>(value(gen));
+    }
+    const Matrix<T> expected = multiply(a, b, matrixKernels<T>(SimdLevel::Scalar));
+    bool ok = multiply(pool, a, b) == expected;
+    for (SimdLevel level : levels) {
+        ok = ok && multiply(a, b, matrixKernels<T>(level)) == expected;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t maxSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : ThreadPool::defaultThreadCount();
+
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+#ifdef SIMD_KERNELS_X86
+    if (simdLevel() == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+#endif
+
+    ThreadPool pool(threads);
+    std::mt19937 gen(42);
+    bool ok = true;
+    for (std::size_t rows : {1, 3, 67, 130}) {
+        ok = ok && kernelsAgree<int>(levels, pool, rows, 300, 37, gen) &&
+             kernelsAgree<float>(levels, pool, rows, 300, 37, gen) &&
+             kernelsAgree<double>(levels, pool, rows, 300, 523, gen);
+    }
+
+    std::cout << "Microseconds per operation (speedup over the nested vectors); parallel multiply on "
+              << pool.size() << " threads" << std::endl;
+    std::cout << std::setw(5) << "size" << std::setw(13) << "add nested" << std::setw(22) << "Matrix +"
+              << std::setw(22) << "Matrix +=" << std::setw(15) << "mul nested";
+    for (SimdLevel level : levels) {
+        std::cout << std::setw(22) << simdLevelName(level);
+    }
+    std::cout << std::setw(22) << "parallel" << std::endl;
+
+    std::uniform_int_distribution<int> value(0, 9);
+    for (std::size_t n = 2; n <= maxSize; n *= 2) {
+        NestedMatrix nestedA(n, std::vector<int>(n));
+        NestedMatrix nestedB(n, std::vector<int>(n));
+        Matrix<int> a(n, n);
+        Matrix<int> b(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                a[i][j] = nestedA[i][j] = value(gen);
+                b[i][j] = nestedB[i][j] = value(gen);
+            }
+        }
+        // Enough repeats of the small cases to take about a millisecond
+        const double elements = static_cast<double>(n * n);
+        const std::size_t addRepeats = std::max<std::size_t>(1, static_cast<std::size_t>(1e6 / elements));
+        const std::size_t multiplyRepeats =
+            std::max<std::size_t>(1, static_cast<std::size_t>(1e6 / (elements * static_cast<double>(n))));
+        const int repeats = n <= 1024 ? 3 : 1;
+
+        // Add, with a new matrix for the sum as in More_Topics.cpp, and in place
+        NestedMatrix nestedSum;
+        double nestedAddTime = measureSeconds(3, [&] {
+            for (std::size_t r = 0; r < addRepeats; ++r) {
+                nestedSum = nestedAdd(nestedA, nestedB);
+                doNotOptimize(nestedSum);
+            }
+        }) / static_cast<double>(addRepeats);
+        Matrix<int> sum;
+        double addTime = measureSeconds(3, [&] {
+            for (std::size_t r = 0; r < addRepeats; ++r) {
+                sum = a + b;
+                doNotOptimize(sum);
+            }
+        }) / static_cast<double>(addRepeats);
+        ok = ok && sameRows(sum, nestedSum);
+        Matrix<int> accumulated = a;
+        double addInPlaceTime = measureSeconds(3, [&] {
+            for (std::size_t r = 0; r < addRepeats; ++r) {
+                accumulated += b;
+                doNotOptimize(accumulated);
+            }
+        }) / static_cast<double>(addRepeats);
+
+        // Multiply; beyond 1024x1024 the nested loop only computes the first 64 rows
+        const std::size_t nestedRows = n <= 1024 ? n : 64;
+        NestedMatrix nestedProduct;
+        double nestedMultiplyTime = measureSeconds(repeats, [&] {
+            for (std::size_t r = 0; r < multiplyRepeats; ++r) {
+                nestedProduct = nestedMultiply(nestedA, nestedB, nestedRows);
+                doNotOptimize(nestedProduct);
+            }
+        }) / static_cast<double>(multiplyRepeats) * static_cast<double>(n / nestedRows);
+
+        std::cout << std::setw(5) << n;
+        printTime(nestedAddTime, 0);
+        printTime(addTime, nestedAddTime);
+        printTime(addInPlaceTime, nestedAddTime);
+        printTime(nestedMultiplyTime, 0);
+        for (SimdLevel level : levels) {
+            if (level == SimdLevel::Scalar && n > 1024 && levels.size() > 1) {
+                std::cout << std::setw(22) << "-";
+                continue;
+            }
+            const MatrixKernels<int>& kernels = matrixKernels<int>(level);
+            Matrix<int> product;
+            double time = measureSeconds(repeats, [&] {
+                for (std::size_t r = 0; r < multiplyRepeats; ++r) {
+                    product = multiply(a, b, kernels);
+                    doNotOptimize(product);
+                }
+            }) / static_cast<double>(multiplyRepeats);
+            ok = ok && sameRows(product, nestedProduct);
+            printTime(time, nestedMultiplyTime);
+        }
+        Matrix<int> product;
+        double parallelTime = measureSeconds(repeats, [&] {
+            for (std::size_t r = 0; r < multiplyRepeats; ++r) {
+                product = multiply(pool, a, b);
+                doNotOptimize(product);
+            }
+        }) / static_cast<double>(multiplyRepeats);
+        ok = ok && sameRows(product, nestedProduct);
+        printTime(parallelTime, nestedMultiplyTime);
+        std::cout << std::endl;
+    }
+
+    std::cout << (ok ? "All products and sums match." : "Results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
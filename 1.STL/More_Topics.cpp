@@ -3,9 +3,11 @@
 #include <complex>
 #include <vector>
 #include <random>
-#include <regex>
 #include <cmath>
 
+#include "Matrix.h"
+#include "Word_Tokenizer.h"
+
 int main() {
     // Date and Time
     std::time_t now = std::time(nullptr);
@@ -17,22 +19,12 @@ int main() {
     std::complex<double> complexSum = complex1 + complex2;
     std::cout << "Sum of complex numbers: " << complexSum << std::endl;
 
-    // Matrix math (using a simple 2x2 matrix example)
-    std::vector<std::vector<int>> matrix1 = {{1, 2}, {3, 4}};
-    std::vector<std::vector<int>> matrix2 = {{5, 6}, {7, 8}};
-    std::vector<std::vector<int>> matrixSum(2, std::vector<int>(2));
-    for (int i = 0; i < 2; ++i) {
-        for (int j = 0; j < 2; ++j) {
-            matrixSum[i][j] = matrix1[i][j] + matrix2[i][j];
-        }
-    }
-    std::cout << "Sum of matrices: " << std::endl;
-    for (const auto& row : matrixSum) {
-        for (const auto& elem : row) {
-            std::cout << elem << " ";
-        }
-        std::cout << std::endl;
-    }
+    // Matrix math (using a simple 2x2 matrix example), in one contiguous buffer (see Matrix.h)
+    Matrix<int> matrix1 = {{1, 2}, {3, 4}};
+    Matrix<int> matrix2 = {{5, 6}, {7, 8}};
+    Matrix<int> matrixSum = matrix1 + matrix2;
+    std::cout << "Sum of matrices: " << std::endl << matrixSum;
+    std::cout << "Product of matrices: " << std::endl << matrix1 * matrix2;
 
     // Random number generator
     std::random_device rd;
@@ -40,14 +32,12 @@ int main() {
     std::uniform_int_distribution<> dis(1, 100);
     std::cout << "Random number: " << dis(gen) << std::endl;
 
-    // Regular expressions
+    // Word extraction with the matches of std::regex("(\\b\\w+\\b)"), without building a
+    // regex or a string per word (see Word_Tokenizer.h)
     std::string text = "The quick brown fox jumps over the lazy dog.";
-    std::regex word_regex("(\\b\\w+\\b)");
-    auto words_begin = std::sregex_iterator(text.begin(), text.end(), word_regex);
-    auto words_end = std::sregex_iterator();
     std::cout << "Words in the text: ";
-    for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-        std::cout << (*i).str() << " ";
+    for (std::string_view word : WordTokenizer(text)) {
+        std::cout << word << " ";
     }
     std::cout << std::endl;
 
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// MpmcQueue: a bounded, lock-free, multi-producer / multi-consumer ring buffer
+//
+// std::queue is not thread-safe, and wrapping it in a mutex makes every producer and
+// consumer contend for the same lock. MpmcQueue is a fixed-size ring of slots where each
+// slot carries a sequence number (Dmitry Vyukov's bounded MPMC queue):
+//  - a producer claims a position with one compare-and-swap on the tail, constructs the
+//    element in the slot and then publishes it by bumping the slot's sequence
+//  - a consumer does the same on the head
+// Producers and consumers only meet on the slot they hand over, and the head and tail
+// indices live on separate cache lines so they do not bounce between cores.
+//
+// Elements leave the queue in the order their positions were claimed (FIFO per producer).
+// The try* functions never block; push/emplace/pop spin (yielding) until they succeed.
+// If constructing an element throws, its claimed slot is still published, marked empty,
+// and consumers skip it; the exception reaches the producer and nothing is queued.
+template <typename T>
+class MpmcQueue {
+public:
+    // Size of a cache line on the platforms we target
+    static constexpr std::size_t kCacheLine = 64;
+
+    // The capacity is rounded up to a power of two (at least 2)
+    explicit MpmcQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask = size - 1;
+        slots = static_cast<Slot*>(::operator new(size * sizeof(Slot), std::align_val_t(alignof(Slot))));
+        for (std::size_t i = 0; i < size; ++i) {
+            ::new (static_cast<void*>(slots + i)) Slot();
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        // Destroy whatever is still queued (no other thread may use the queue any more)
+        std::size_t head = dequeuePos.value.load(std::memory_order_acquire);
+        std::size_t tail = enqueuePos.value.load(std::memory_order_acquire);
+        for (std::size_t pos = head; pos != tail; ++pos) {
+            if (slots[pos & mask].filled) {
+                slots[pos & mask].element()->~T();
+            }
+        }
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].~Slot();
+        }
+        ::operator delete(slots, std::align_val_t(alignof(Slot)));
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // Approximate number of queued elements (exact only when no other thread is active;
+    // slots left empty by a throwing constructor count until a consumer skips them)
+    std::size_t size() const {
+        std::size_t tail = enqueuePos.value.load(std::memory_order_acquire);
+        std::size_t head = dequeuePos.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Constructs an element in place; returns false if the queue is full
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        std::size_t pos = enqueuePos.value.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // The slot is free for this position; try to claim it
+                if (enqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // The slot still holds an element from the previous lap: full
+            } else {
+                pos = enqueuePos.value.load(std::memory_order_relaxed);
+            }
+        }
+        try {
+            ::new (slot->storage()) T(std::forward<Args>(args)...);
+        } catch (...) {
+            publishEmpty(pos, pos + 1);
+            throw;
+        }
+        slot->filled = true;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value) { return tryEmplace(value); }
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    // Moves the oldest element into value; returns false if the queue is empty
+    bool tryPop(T& value) {
+        std::size_t pos;
+        Slot* slot = claimDequeue(pos);
+        if (slot == nullptr) {
+            return false;
+        }
+        value = std::move(*slot->element());
+        release(*slot, pos);
+        return true;
+    }
+
+    // Same as tryPop(T&), for element types without a default constructor
+    std::optional<T> tryPop() {
+        std::optional<T> result;
+        std::size_t pos;
+        Slot* slot = claimDequeue(pos);
+        if (slot != nullptr) {
+            result.emplace(std::move(*slot->element()));
+            release(*slot, pos);
+        }
+        return result;
+    }
+
+    // Pushes up to count elements from first with a single claim on the tail.
+    // Returns how many were pushed (fewer than count if the queue fills up).
+    template <typename InputIt>
+    std::size_t tryPushBatch(InputIt first, std::size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+        std::size_t pos = enqueuePos.value.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        for (;;) {
+            // Count how many consecutive slots starting at pos are free for this lap
+            claimed = 0;
+            while (claimed < count && claimed <= mask &&
+                   slots[(pos + claimed) & mask].sequence.load(std::memory_order_acquire) == pos + claimed) {
+                ++claimed;
+            }
+            if (claimed == 0) {
+                std::size_t sequence = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) < 0) {
+                    return 0; // Full
+                }
+                pos = enqueuePos.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueuePos.value.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::size_t i = 0;
+        try {
+            for (; i < claimed; ++i, ++first) {
+                Slot& slot = slots[(pos + i) & mask];
+                ::new (slot.storage()) T(*first);
+                slot.filled = true;
+                slot.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+        } catch (...) {
+            // The rest of the claim must be published too, or consumers would wait on it forever
+            publishEmpty(pos + i, pos + claimed);
+            throw;
+        }
+        return claimed;
+    }
+
+    // Pops up to maxCount elements into out with a single claim on the head.
+    // Returns how many were popped (empty slots in the claim are skipped, not counted).
+    template <typename OutputIt>
+    std::size_t tryPopBatch(OutputIt out, std::size_t maxCount) {
+        if (maxCount == 0) {
+            return 0;
+        }
+        std::size_t pos = dequeuePos.value.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        for (;;) {
+            claimed = 0;
+            while (claimed < maxCount && claimed <= mask &&
+                   slots[(pos + claimed) & mask].sequence.load(std::memory_order_acquire) == pos + claimed + 1) {
+                ++claimed;
+            }
+            if (claimed == 0) {
+                std::size_t sequence = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0) {
+                    return 0; // Empty
+                }
+                pos = dequeuePos.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeuePos.value.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::size_t popped = 0;
+        for (std::size_t i = 0; i < claimed; ++i) {
+            Slot& slot = slots[(pos + i) & mask];
+            if (slot.filled) {
+                *out = std::move(*slot.element());
+                ++out;
+                ++popped;
+            }
+            release(slot, pos + i);
+        }
+        return popped;
+    }
+
+    // Blocking variants: spin until there is room / an element
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        while (!tryEmplace(std::forward<Args>(args)...)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    void pop(T& value) {
+        while (!tryPop(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        bool filled = false; // False if the constructor threw; published with sequence
+        alignas(T) unsigned char data[sizeof(T)];
+
+        void* storage() { return data; }
+        T* element() { return std::launder(reinterpret_cast<T*>(data)); }
+    };
+
+    // Keeps an index alone on its cache line
+    struct alignas(kCacheLine) PaddedIndex {
+        std::atomic<std::size_t> value{0};
+        char padding[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    };
+
+    // Claims the oldest published position that holds an element (releasing the empty ones
+    // on the way); returns nullptr if the queue is empty
+    Slot* claimDequeue(std::size_t& pos) {
+        pos = dequeuePos.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot* slot = &slots[pos & mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    if (slot->filled) {
+                        return slot;
+                    }
+                    release(*slot, pos);
+                    pos = dequeuePos.value.load(std::memory_order_relaxed);
+                }
+            } else if (diff < 0) {
+                return nullptr; // Nothing published at this position yet: empty
+            } else {
+                pos = dequeuePos.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Destroys the element, if any, and marks the slot free for the producer one lap ahead
+    void release(Slot& slot, std::size_t pos) {
+        if (slot.filled) {
+            slot.element()->~T();
+        }
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+    }
+
+    // Publishes the claimed positions [pos, end) without elements, after a constructor threw
+    void publishEmpty(std::size_t pos, std::size_t end) {
+        for (; pos != end; ++pos) {
+            Slot& slot = slots[pos & mask];
+            slot.filled = false;
+            slot.sequence.store(pos + 1, std::memory_order_release);
+        }
+    }
+
+    PaddedIndex enqueuePos;
+    PaddedIndex dequeuePos;
+    Slot* slots = nullptr;
+    std::size_t mask = 0;
+};
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Mpmc_Queue.h"
+#include "Person.h"
+
+// Stress test and throughput benchmark for MpmcQueue<Person>
+//
+// The stress test runs several producers and consumers (mixing single and batch
+// operations) and checks that every Person arrives exactly once and that each consumer
+// sees each producer's elements in order. A second run uses a payload whose copy
+// constructor throws for some elements and checks that those are dropped, the others
+// still arrive exactly once and in order, and no consumer gets stuck. The benchmark then passes Person records from
+// 1 to N producer threads to as many consumer threads, through MpmcQueue and through a
+// std::queue guarded by a std::mutex.
+//
+// Usage: Mpmc_Queue_Benchmark [itemsPerProducer] [maxThreads]
+//        (defaults: 200000 and std::thread::hardware_concurrency())
+// Build with optimizations and threads, e.g. g++ -std=c++17 -O3 -pthread
+
+// std::queue with a mutex around every operation, as a baseline
+template <typename T>
+class LockedQueue {
+public:
+    void push(T value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(std::move(value));
+    }
+
+    bool tryPop(T& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return false;
+        }
+        value = std::move(queue.front());
+        queue.pop();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::queue<T> queue;
+};
+
+// Every element carries its producer in the name and its sequence number in the age
+bool runStressTest(int producers, int consumers, int itemsPerProducer) {
+    MpmcQueue<Person> queue(64); // Small on purpose, so the queue is often full and empty
+    const long long total = static_cast<long long>(producers) * itemsPerProducer;
+    std::atomic<long long> consumed{0};
+    std::atomic<bool> ok{true};
+    std::vector<std::vector<int>> seenCounts(producers, std::vector<int>(itemsPerProducer, 0));
+    std::mutex seenMutex;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::string name = std::to_string(p);
+            int next = 0;
+            while (next < itemsPerProducer) {
+                if (next % 3 == 0) {
+                    // Batch push of up to 8 elements
+                    std::vector<Person> batch;
+                    for (int i = next; i < std::min(next + 8, itemsPerProducer); ++i) {
+                        batch.push_back(Person(name, i));
+                    }
+                    next += static_cast<int>(queue.tryPushBatch(batch.begin(), batch.size()));
+                } else if (queue.tryEmplace(name, next)) {
+                    ++next;
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int> lastSeen(producers, -1);
+            std::vector<Person> batch;
+            while (consumed.load() < total) {
+                batch.clear();
+                std::size_t popped = queue.tryPopBatch(std::back_inserter(batch), 5);
+                if (popped == 0) {
+                    if (auto person = queue.tryPop()) {
+                        batch.push_back(*person);
+                    } else {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+                std::lock_guard<std::mutex> lock(seenMutex);
+                for (const Person& person : batch) {
+                    int producer = std::stoi(std::string(person.getName()));
+                    int sequence = person.getAge();
+                    if (sequence <= lastSeen[producer]) {
+                        ok = false; // Out of order for this producer
+                    }
+                    lastSeen[producer] = sequence;
+                    ++seenCounts[producer][sequence];
+                }
+                consumed += static_cast<long long>(batch.size());
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const std::vector<int>& counts : seenCounts) {
+        for (int count : counts) {
+            if (count != 1) {
+                ok = false; // Lost or duplicated
+            }
+        }
+    }
+    return ok && queue.empty();
+}
+
+// Copying throws for every sequence number that is 3 modulo 7, as copying a Person's name
+// can throw std::bad_alloc
+struct FlakyPayload {
+    int producer;
+    int sequence;
+
+    static bool copyThrows(int sequence) { return sequence % 7 == 3; }
+
+    FlakyPayload(int producer, int sequence) : producer(producer), sequence(sequence) {}
+    FlakyPayload(const FlakyPayload& other) : producer(other.producer), sequence(other.sequence) {
+        if (copyThrows(sequence)) {
+            throw std::runtime_error("FlakyPayload: copy failed");
+        }
+    }
+    FlakyPayload(FlakyPayload&&) noexcept = default;
+    FlakyPayload& operator=(FlakyPayload&&) noexcept = default;
+};
+
+// Producers push copies (single and batch), so the elements whose copy throws never enter
+// the queue; every other element must arrive exactly once, in order per producer
+bool runThrowingStressTest(int producers, int consumers, int itemsPerProducer) {
+    MpmcQueue<FlakyPayload> queue(64);
+    long long total = 0;
+    for (int i = 0; i < itemsPerProducer; ++i) {
+        total += FlakyPayload::copyThrows(i) ? 0 : producers;
+    }
+    std::atomic<long long> consumed{0};
+    std::atomic<bool> ok{true};
+    std::vector<std::vector<int>> seenCounts(producers, std::vector<int>(itemsPerProducer, 0));
+    std::mutex seenMutex;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            int next = 0;
+            while (next < itemsPerProducer) {
+                if (next % 3 == 0) {
+                    std::vector<FlakyPayload> batch;
+                    for (int i = next; i < std::min(next + 8, itemsPerProducer); ++i) {
+                        batch.emplace_back(p, i);
+                    }
+                    try {
+                        next += static_cast<int>(queue.tryPushBatch(batch.begin(), batch.size()));
+                    } catch (const std::runtime_error&) {
+                        // Everything before the failed element was pushed; skip that one
+                        while (!FlakyPayload::copyThrows(next)) {
+                            ++next;
+                        }
+                        ++next;
+                    }
+                } else {
+                    const FlakyPayload payload(p, next);
+                    try {
+                        if (queue.tryPush(payload)) {
+                            ++next;
+                        }
+                    } catch (const std::runtime_error&) {
+                        ++next;
+                    }
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int> lastSeen(producers, -1);
+            std::vector<FlakyPayload> batch;
+            while (consumed.load() < total) {
+                batch.clear();
+                if (queue.tryPopBatch(std::back_inserter(batch), 5) == 0) {
+                    if (auto payload = queue.tryPop()) {
+                        batch.push_back(std::move(*payload));
+                    } else {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+                std::lock_guard<std::mutex> lock(seenMutex);
+                for (const FlakyPayload& payload : batch) {
+                    if (payload.sequence <= lastSeen[payload.producer]) {
+                        ok = false;
+                    }
+                    lastSeen[payload.producer] = payload.sequence;
+                    ++seenCounts[payload.producer][payload.sequence];
+                }
+                consumed += static_cast<long long>(batch.size());
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const std::vector<int>& counts : seenCounts) {
+        for (int sequence = 0; sequence < itemsPerProducer; ++sequence) {
+            if (counts[sequence] != (FlakyPayload::copyThrows(sequence) ? 0 : 1)) {
+                ok = false;
+            }
+        }
+    }
+    // Slots left empty at the end are skipped by the next pop
+    return ok && !queue.tryPop() && queue.empty();
+}
+
+// Moves itemsPerProducer Persons from each of `threadCount` producers to `threadCount` consumers
+template <typename Queue, typename Push, typename Pop>
+double measureThroughput(int threadCount, int itemsPerProducer, Push push, Pop pop) {
+    Queue queue;
+    const long long total = static_cast<long long>(threadCount) * itemsPerProducer;
+    std::atomic<long long> consumed{0};
+    std::atomic<long long> checksum{0};
+
+    double seconds = measureSeconds(1, [&] {
+        std::vector<std::thread> threads;
+        for (int p = 0; p < threadCount; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < itemsPerProducer; ++i) {
+                    push(queue, Person("Alice", i));
+                }
+            });
+        }
+        for (int c = 0; c < threadCount; ++c) {
+            threads.emplace_back([&] {
+                Person person("", 0);
+                long long sum = 0;
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    if (pop(queue, person)) {
+                        sum += person.getAge();
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                checksum += sum;
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    });
+
+    long long expected = static_cast<long long>(threadCount) * itemsPerProducer * (itemsPerProducer - 1LL) / 2;
+    if (checksum != expected) {
+        std::cout << "Checksum mismatch!" << std::endl;
+        std::exit(1);
+    }
+    return static_cast<double>(total) / seconds / 1e6;
+}
+
+// MpmcQueue has no default constructor, so the benchmark wraps it
+struct BenchmarkMpmcQueue : MpmcQueue<Person> {
+    BenchmarkMpmcQueue() : MpmcQueue<Person>(4096) {}
+};
+
+int main(int argc, char** argv) {
+    int itemsPerProducer = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::cout << "Stress test (4x4, 1x3 and 3x1 producers x consumers): ";
+    bool passed = runStressTest(4, 4, 20000) && runStressTest(1, 3, 20000) && runStressTest(3, 1, 20000);
+    std::cout << (passed ? "passed" : "FAILED") << std::endl;
+    if (!passed) {
+        return 1;
+    }
+    std::cout << "Stress test with throwing copies (4x4 and 2x1): ";
+    passed = runThrowingStressTest(4, 4, 20000) && runThrowingStressTest(2, 1, 20000);
+    std::cout << (passed ? "passed" : "FAILED") << std::endl;
+    if (!passed) {
+        return 1;
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(22) << "MpmcQueue Mops/s" << std::setw(26)
+              << "mutex+std::queue Mops/s" << std::endl;
+    // 1, 2, 4, ... and always maxThreads itself
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (int threads : threadCounts) {
+        double lockFree = measureThroughput<BenchmarkMpmcQueue>(
+            threads, itemsPerProducer,
+            [](BenchmarkMpmcQueue& queue, Person person) { queue.push(std::move(person)); },
+            [](BenchmarkMpmcQueue& queue, Person& person) { return queue.tryPop(person); });
+        double locked = measureThroughput<LockedQueue<Person>>(
+            threads, itemsPerProducer,
+            [](LockedQueue<Person>& queue, Person person) { queue.push(std::move(person)); },
+            [](LockedQueue<Person>& queue, Person& person) { return queue.tryPop(person); });
+        std::cout << std::setw(10) << threads << std::fixed << std::setprecision(2) << std::setw(22) << lockFree
+                  << std::setw(26) << locked << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "Flat_Hash_Map.h"
+
+// NamePool: a global string-interning pool for names
+//
+// The same few names ("Alice", "Bob", ...) show up in thousands of Person objects, and
+// every std::string copy of a long name is another heap allocation. NamePool stores each
+// distinct name once; an InternedName is just a pointer to that single copy, so copying
+// it (or a Person built from it) never allocates.
+//
+// Interning is optional: Person objects built from a std::string keep their own copy.
+// Interned names live until the end of the program. The pool is thread-safe.
+
+class NamePool;
+
+// A handle to a name stored in the NamePool; cheap to copy, compares by pointer
+class InternedName {
+public:
+    std::string_view view() const { return *entry; }
+    const std::string& str() const { return *entry; }
+
+    bool operator==(const InternedName& other) const { return entry == other.entry; }
+    bool operator!=(const InternedName& other) const { return entry != other.entry; }
+
+private:
+    friend class NamePool;
+
+    explicit InternedName(const std::string* entry) : entry(entry) {}
+
+    const std::string* entry;
+};
+
+class NamePool {
+public:
+    // The process-wide pool used by internName()
+    static NamePool& global() {
+        static NamePool pool;
+        return pool;
+    }
+
+    // Returns the pooled copy of name, adding it on first use
+    InternedName intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(name);
+        if (it != index.end()) {
+            return InternedName(it->second);
+        }
+        // std::deque never moves its elements, so the views used as keys stay valid
+        const std::string& stored = names.emplace_back(name);
+        index.emplace(std::string_view(stored), &stored);
+        return InternedName(&stored);
+    }
+
+    // Number of distinct names in the pool
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return names.size();
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::deque<std::string> names;
+    FlatHashMap<std::string_view, const std::string*> index;
+};
+
+// Shorthand for NamePool::global().intern(name)
+inline InternedName internName(std::string_view name) {
+    return NamePool::global().intern(name);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+// NodePool: a memory resource that hands out small fixed-size blocks from large chunks
+//
+// A std::list calls the allocator once per node, and with the default allocator every
+// push_back is a malloc and every node ends up somewhere else on the heap. NodePool
+// carves nodes out of big chunks instead, so neighbouring nodes sit next to each other,
+// and it keeps a free list per block size, so nodes released by erase/pop_back are
+// reused by the next insert without going back to malloc.
+//
+// It plugs into any std::pmr container:
+//     NodePool pool;
+//     std::pmr::list<Person> people(&pool);
+//
+// Requests are rounded up to a multiple of 16 bytes; anything larger than kMaxBlockSize
+// (or over-aligned) is forwarded to the upstream resource. Memory is returned to the
+// upstream resource only when the pool is destroyed or release() is called.
+// Like std::pmr::unsynchronized_pool_resource, a NodePool must not be shared between threads.
+class NodePool : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kGranularity = 16;
+    static constexpr std::size_t kMaxBlockSize = 256;
+
+    explicit NodePool(std::size_t firstChunkBlocks = 64,
+                      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : firstChunkBlocks(firstChunkBlocks == 0 ? 1 : firstChunkBlocks), upstream(upstream) {
+        for (SizeClass& sizeClass : classes) {
+            sizeClass.nextChunkBlocks = this->firstChunkBlocks;
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() override {
+        release();
+    }
+
+    // Returns every chunk to the upstream resource. Containers using the pool must be gone.
+    void release() {
+        while (chunks != nullptr) {
+            ChunkHeader* next = chunks->next;
+            upstream->deallocate(chunks, chunks->bytes, alignof(std::max_align_t));
+            chunks = next;
+        }
+        for (SizeClass& sizeClass : classes) {
+            sizeClass = SizeClass();
+            sizeClass.nextChunkBlocks = firstChunkBlocks;
+        }
+        liveBlocks = 0;
+        recycledBlocks = 0;
+        chunkCount = 0;
+    }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream; }
+
+    // Statistics
+    std::size_t blocksInUse() const { return liveBlocks; }
+    std::size_t blocksRecycled() const { return recycledBlocks; }
+    std::size_t chunksAllocated() const { return chunkCount; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes > kMaxBlockSize || alignment > alignof(std::max_align_t)) {
+            return upstream->allocate(bytes, alignment);
+        }
+        SizeClass& sizeClass = classes[classIndex(bytes)];
+
+        // Reuse a released block first
+        if (sizeClass.freeList != nullptr) {
+            FreeBlock* block = sizeClass.freeList;
+            sizeClass.freeList = block->next;
+            ++recycledBlocks;
+            ++liveBlocks;
+            return block;
+        }
+
+        // Then bump-allocate from the current chunk
+        const std::size_t blockSize = (classIndex(bytes) + 1) * kGranularity;
+        if (sizeClass.cursor == sizeClass.limit) {
+            addChunk(sizeClass, blockSize);
+        }
+        void* block = sizeClass.cursor;
+        sizeClass.cursor += blockSize;
+        ++liveBlocks; // Only now: addChunk may have thrown
+        return block;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (bytes > kMaxBlockSize || alignment > alignof(std::max_align_t)) {
+            upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        SizeClass& sizeClass = classes[classIndex(bytes)];
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = sizeClass.freeList;
+        sizeClass.freeList = block;
+        --liveBlocks;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Placed at the start of every chunk so release() can walk them
+    struct alignas(std::max_align_t) ChunkHeader {
+        ChunkHeader* next;
+        std::size_t bytes;
+    };
+
+    struct SizeClass {
+        FreeBlock* freeList = nullptr;
+        char* cursor = nullptr;
+        char* limit = nullptr;
+        std::size_t nextChunkBlocks = 0;
+    };
+
+    static std::size_t classIndex(std::size_t bytes) {
+        return bytes == 0 ? 0 : (bytes - 1) / kGranularity;
+    }
+
+    // Chunks double in size (up to 64K blocks), so a growing list needs only a few of them
+    void addChunk(SizeClass& sizeClass, std::size_t blockSize) {
+        const std::size_t blocks = sizeClass.nextChunkBlocks;
+        const std::size_t bytes = sizeof(ChunkHeader) + blocks * blockSize;
+        ChunkHeader* chunk = static_cast<ChunkHeader*>(upstream->allocate(bytes, alignof(std::max_align_t)));
+        chunk->next = chunks;
+        chunk->bytes = bytes;
+        chunks = chunk;
+        ++chunkCount;
+
+        sizeClass.cursor = reinterpret_cast<char*>(chunk + 1);
+        sizeClass.limit = sizeClass.cursor + blocks * blockSize;
+        if (sizeClass.nextChunkBlocks < 65536) {
+            sizeClass.nextChunkBlocks *= 2;
+        }
+    }
+
+    SizeClass classes[kMaxBlockSize / kGranularity];
+    ChunkHeader* chunks = nullptr;
+    std::size_t firstChunkBlocks;
+    std::pmr::memory_resource* upstream;
+
+    std::size_t liveBlocks = 0;
+    std::size_t recycledBlocks = 0;
+    std::size_t chunkCount = 0;
+};
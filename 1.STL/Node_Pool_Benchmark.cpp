@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Node_Pool.h"
+#include "Person.h"
+
+// Insert / erase / traversal throughput of std::list with the default allocator,
+// std::pmr::list backed by a NodePool, and std::vector, for int and Person payloads.
+//
+// Each round: push_back n elements, traverse them, erase every second element,
+// push_back n/2 new elements (which reuse the erased nodes), traverse again.
+//
+// Usage: Node_Pool_Benchmark [elements]   (default: 1000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+int valueOf(int value) {
+    return value;
+}
+
+int valueOf(const Person& person) {
+    return person.getAge();
+}
+
+template <typename T>
+T makeElement(std::size_t i) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    } else {
+        return T("Person", static_cast<int>(i % 100));
+    }
+}
+
+struct Timings {
+    double insertMs = 0;
+    double traverseMs = 0;
+    double eraseMs = 0;
+    long long checksum = 0;
+};
+
+// Works for std::list, std::pmr::list and std::vector, as all three have push_back/erase
+template <typename Container>
+Timings runRound(Container& container, std::size_t n) {
+    using T = typename Container::value_type;
+    Timings timings;
+
+    timings.insertMs += measureSeconds(1, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            container.push_back(makeElement<T>(i));
+        }
+    }) * 1e3;
+
+    auto traverse = [&] {
+        long long sum = 0;
+        for (const T& element : container) {
+            sum += valueOf(element);
+        }
+        timings.checksum += sum;
+    };
+    timings.traverseMs += measureSeconds(1, traverse) * 1e3;
+
+    // Erasing every second element is O(1) per element for a list; the vector uses
+    // the erase-remove idiom, since erasing one by one would be quadratic
+    timings.eraseMs += measureSeconds(1, [&] {
+        if constexpr (std::is_same_v<Container, std::vector<T>>) {
+            std::size_t index = 0;
+            container.erase(std::remove_if(container.begin(), container.end(),
+                                           [&index](const T&) { return index++ % 2 == 0; }),
+                            container.end());
+        } else {
+            for (auto it = container.begin(); it != container.end();) {
+                it = container.erase(it);
+                if (it != container.end()) {
+                    ++it;
+                }
+            }
+        }
+    }) * 1e3;
+
+    timings.insertMs += measureSeconds(1, [&] {
+        for (std::size_t i = 0; i < n / 2; ++i) {
+            container.push_back(makeElement<T>(i));
+        }
+    }) * 1e3;
+    timings.traverseMs += measureSeconds(1, traverse) * 1e3;
+
+    return timings;
+}
+
+template <typename T>
+void benchmarkPayload(const char* payload, std::size_t n) {
+    auto print = [payload](const char* container, const Timings& timings) {
+        std::cout << std::setw(8) << payload << std::setw(24) << container << std::fixed << std::setprecision(2)
+                  << std::setw(12) << timings.insertMs << std::setw(12) << timings.eraseMs
+                  << std::setw(12) << timings.traverseMs << std::endl;
+    };
+
+    std::list<T> defaultList;
+    Timings defaultTimings = runRound(defaultList, n);
+    print("std::list", defaultTimings);
+
+    NodePool pool;
+    Timings pooledTimings;
+    {
+        std::pmr::list<T> pooledList(&pool);
+        pooledTimings = runRound(pooledList, n);
+    }
+    print("std::pmr::list+NodePool", pooledTimings);
+
+    std::vector<T> vector;
+    Timings vectorTimings = runRound(vector, n);
+    print("std::vector", vectorTimings);
+
+    if (defaultTimings.checksum != pooledTimings.checksum || defaultTimings.checksum != vectorTimings.checksum) {
+        std::cout << "Checksum mismatch!" << std::endl;
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::cout << "Elements: " << n << std::endl;
+    std::cout << std::setw(8) << "payload" << std::setw(24) << "container"
+              << std::setw(12) << "insert ms" << std::setw(12) << "erase ms" << std::setw(12) << "iterate ms" << std::endl;
+
+    benchmarkPayload<int>("int", n);
+    benchmarkPayload<Person>("Person", n);
+
+    return 0;
+}
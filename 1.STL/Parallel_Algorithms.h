@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "Thread_Pool.h"
+
+// Parallel versions of for_each, find_if, sort and binary_search on a ThreadPool
+//
+// They take the same arguments as the std algorithms plus the pool to run on, and give
+// the same results as the serial calls (checked by Parallel_Algorithms_Benchmark.cpp):
+//     ThreadPool pool;
+//     parallelForEach(pool, vec.begin(), vec.end(), [](int& n) { n++; });
+//     auto it = parallelFindIf(pool, vec.begin(), vec.end(), [](int n) { return n > 5; });
+//     parallelSort(pool, vec.begin(), vec.end());
+// Ranges shorter than kParallelThreshold elements are handled by the std algorithm,
+// because waking the workers costs more than the loop itself.
+//
+// std::execution::par_unseq would cover the same ground, but with GCC it needs Intel TBB
+// and MSVC's version cannot be tuned; these only need <thread>.
+
+// Below this many elements the parallel algorithms run serially
+constexpr std::size_t kParallelThreshold = 1 << 15;
+
+// Start of chunk i when n elements are split into `chunks` nearly equal parts
+inline std::size_t chunkBegin(std::size_t n, std::size_t chunks, std::size_t i) {
+    return static_cast<std::size_t>(static_cast<unsigned long long>(n) * i / chunks);
+}
+
+// Calls fn on every element; each thread works on one contiguous chunk
+template <typename RandomIt, typename Fn>
+void parallelForEach(ThreadPool& pool, RandomIt first, RandomIt last, Fn fn) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < kParallelThreshold || pool.size() == 1) {
+        std::for_each(first, last, fn);
+        return;
+    }
+    const std::size_t chunks = pool.size();
+    pool.run(chunks, [&](std::size_t i) {
+        std::for_each(first + chunkBegin(n, chunks, i), first + chunkBegin(n, chunks, i + 1), fn);
+    });
+}
+
+// First element for which pred is true, or last (same result as std::find_if)
+//
+// The range is cut into blocks that are handed out in order. When a thread finds a match
+// it lowers the shared "best position", and every thread stops as soon as the next block
+// it would take starts past that position, so a match near the front ends the search
+// after roughly one block per thread instead of a full scan.
+template <typename RandomIt, typename Predicate>
+RandomIt parallelFindIf(ThreadPool& pool, RandomIt first, RandomIt last, Predicate pred) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < kParallelThreshold || pool.size() == 1) {
+        return std::find_if(first, last, pred);
+    }
+    const std::size_t blockSize = 1 << 14;
+    const std::size_t blockCount = (n + blockSize - 1) / blockSize;
+    std::atomic<std::size_t> nextBlock{0};
+    std::atomic<std::size_t> found{n};
+
+    pool.run(pool.size(), [&](std::size_t) {
+        for (;;) {
+            std::size_t block = nextBlock.fetch_add(1, std::memory_order_relaxed);
+            std::size_t begin = block * blockSize;
+            if (block >= blockCount || begin >= found.load(std::memory_order_relaxed)) {
+                return; // Everything from here on is behind a match that is already known
+            }
+            std::size_t end = std::min(begin + blockSize, n);
+            RandomIt hit = std::find_if(first + begin, first + end, pred);
+            if (hit != first + end) {
+                std::size_t position = static_cast<std::size_t>(hit - first);
+                std::size_t best = found.load(std::memory_order_relaxed);
+                while (position < best && !found.compare_exchange_weak(best, position, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    });
+    return first + found.load();
+}
+
+// Splits the merge of the sorted runs [left, leftEnd) and [right, rightEnd) into out
+// into up to `pieces` independent merges and appends them to tasks. The longer run is cut
+// at evenly spaced positions and the other one at the matching bound, so that equal
+// elements of the left run still come first, as with std::merge.
+template <typename InputIt, typename OutputIt, typename Compare>
+void addMergeTasks(InputIt left, InputIt leftEnd, InputIt right, InputIt rightEnd, OutputIt out, std::size_t pieces,
+                   Compare comp, std::vector<std::function<void()>>& tasks) {
+    const std::size_t leftSize = static_cast<std::size_t>(leftEnd - left);
+    const std::size_t rightSize = static_cast<std::size_t>(rightEnd - right);
+    const bool cutLeft = leftSize >= rightSize;
+    pieces = std::max<std::size_t>(1, std::min(pieces, std::max(leftSize, rightSize)));
+    std::size_t leftBegin = 0;
+    std::size_t rightBegin = 0;
+    for (std::size_t piece = 1; piece <= pieces; ++piece) {
+        std::size_t leftStop = leftSize;
+        std::size_t rightStop = rightSize;
+        if (piece < pieces && cutLeft) {
+            leftStop = chunkBegin(leftSize, pieces, piece);
+            rightStop = static_cast<std::size_t>(std::lower_bound(right, rightEnd, left[leftStop], comp) - right);
+        } else if (piece < pieces) {
+            rightStop = chunkBegin(rightSize, pieces, piece);
+            leftStop = static_cast<std::size_t>(std::upper_bound(left, leftEnd, right[rightStop], comp) - left);
+        }
+        InputIt x = left + leftBegin, xEnd = left + leftStop, y = right + rightBegin, yEnd = right + rightStop;
+        OutputIt target = out + (leftBegin + rightBegin);
+        tasks.push_back([=] {
+            std::merge(std::make_move_iterator(x), std::make_move_iterator(xEnd), std::make_move_iterator(y),
+                       std::make_move_iterator(yEnd), target, comp);
+        });
+        leftBegin = leftStop;
+        rightBegin = rightStop;
+    }
+}
+
+// Sorts the range (same result as std::sort)
+//
+// Each thread sorts one chunk with std::sort, then the sorted chunks are merged pairwise,
+// back and forth between the range and one buffer of the same size. Every merge round
+// uses all threads, because each pair of runs is split into several independent pieces.
+// The buffer needs a default-constructible element type.
+template <typename RandomIt, typename Compare = std::less<>>
+void parallelSort(ThreadPool& pool, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < kParallelThreshold || pool.size() == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    const std::size_t chunks = pool.size();
+    std::vector<std::size_t> runs(chunks + 1);
+    for (std::size_t i = 0; i <= chunks; ++i) {
+        runs[i] = chunkBegin(n, chunks, i);
+    }
+    pool.run(chunks, [&](std::size_t i) {
+        std::sort(first + runs[i], first + runs[i + 1], comp);
+    });
+
+    std::vector<T> buffer(n);
+    bool inBuffer = false; // Where the current runs live
+    std::vector<std::function<void()>> tasks;
+    while (runs.size() > 2) {
+        const std::size_t runCount = runs.size() - 1;
+        const std::size_t pairs = runCount / 2;
+        const std::size_t pieces = std::max<std::size_t>(1, pool.size() / pairs);
+        std::vector<std::size_t> merged;
+        tasks.clear();
+        for (std::size_t r = 0; r + 1 < runCount; r += 2) {
+            merged.push_back(runs[r]);
+            if (inBuffer) {
+                addMergeTasks(buffer.begin() + runs[r], buffer.begin() + runs[r + 1], buffer.begin() + runs[r + 1],
+                              buffer.begin() + runs[r + 2], first + runs[r], pieces, comp, tasks);
+            } else {
+                addMergeTasks(first + runs[r], first + runs[r + 1], first + runs[r + 1], first + runs[r + 2],
+                              buffer.begin() + runs[r], pieces, comp, tasks);
+            }
+        }
+        if (runCount % 2 == 1) {
+            // The odd run out is moved over unchanged
+            std::size_t r = runCount - 1;
+            merged.push_back(runs[r]);
+            if (inBuffer) {
+                tasks.push_back([&, r] {
+                    std::move(buffer.begin() + runs[r], buffer.begin() + runs[r + 1], first + runs[r]);
+                });
+            } else {
+                tasks.push_back([&, r] {
+                    std::move(first + runs[r], first + runs[r + 1], buffer.begin() + runs[r]);
+                });
+            }
+        }
+        pool.run(tasks.size(), [&](std::size_t i) { tasks[i](); });
+        merged.push_back(n);
+        runs.swap(merged);
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer) {
+        pool.run(chunks, [&](std::size_t i) {
+            std::move(buffer.begin() + chunkBegin(n, chunks, i), buffer.begin() + chunkBegin(n, chunks, i + 1),
+                      first + chunkBegin(n, chunks, i));
+        });
+    }
+}
+
+// A single lookup is about log2(n) dependent memory reads, far less work than waking a
+// thread, so it stays serial (same result as std::binary_search)
+template <typename RandomIt, typename T, typename Compare = std::less<>>
+bool parallelBinarySearch(ThreadPool&, RandomIt first, RandomIt last, const T& value, Compare comp = Compare()) {
+    return std::binary_search(first, last, value, comp);
+}
+
+// Looks up many values at once: found[i] = std::binary_search(first, last, values[i]).
+// This is where the parallelism pays off; each thread answers one chunk of the queries.
+template <typename RandomIt, typename ValueIt, typename OutputIt, typename Compare = std::less<>>
+void parallelBinarySearch(ThreadPool& pool, RandomIt first, RandomIt last, ValueIt valuesFirst, ValueIt valuesLast,
+                          OutputIt found, Compare comp = Compare()) {
+    const std::size_t queries = static_cast<std::size_t>(std::distance(valuesFirst, valuesLast));
+    const std::size_t chunks = queries < kParallelThreshold / 16 ? 1 : pool.size();
+    pool.run(chunks, [&](std::size_t chunk) {
+        for (std::size_t i = chunkBegin(queries, chunks, chunk); i < chunkBegin(queries, chunks, chunk + 1); ++i) {
+            found[i] = std::binary_search(first, last, valuesFirst[i], comp);
+        }
+    });
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Parallel_Algorithms.h"
+
+// Scaling benchmark for Parallel_Algorithms.h
+//
+// Runs the four steps of Algorithms.cpp (for_each increment, find_if, sort ascending and
+// descending, binary_search) on a large vector of random ints, first with the std
+// algorithms and then on thread pools of 1, 2, 4, ... up to all hardware threads.
+// Every parallel result is compared with the serial one; any difference is reported and
+// makes the program exit with status 1.
+//
+// Usage: Parallel_Algorithms_Benchmark [elements] [maxThreads]
+//        (defaults: 50000000 and std::thread::hardware_concurrency())
+// Build with optimizations and threads, e.g. g++ -std=c++17 -O3 -pthread
+
+struct Timings {
+    double forEach;
+    double findIf;
+    double sortAscending;
+    double sortDescending;
+    double binarySearch;
+};
+
+void printRow(const char* label, std::size_t threads, const Timings& t, const Timings& serial) {
+    std::cout << std::left << std::setw(10) << label << std::right << std::setw(8) << threads << std::fixed
+              << std::setprecision(1);
+    const double times[] = {t.forEach, t.findIf, t.sortAscending, t.sortDescending, t.binarySearch};
+    const double serialTimes[] = {serial.forEach, serial.findIf, serial.sortAscending, serial.sortDescending,
+                                  serial.binarySearch};
+    for (int i = 0; i < 5; ++i) {
+        std::cout << std::setw(11) << times[i] * 1000.0 << " ms" << std::setw(6) << std::setprecision(2)
+                  << serialTimes[i] / times[i] << "x" << std::setprecision(1);
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    std::size_t maxThreads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : ThreadPool::defaultThreadCount();
+    const int repeats = 3;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, 1000000000);
+    std::vector<int> data(elements);
+    for (int& value : data) {
+        value = dis(gen);
+    }
+    // find_if looks for the first value above this; it only occurs at about 3/4 of the way in
+    const int findLimit = 1000000000;
+    if (elements > 0) {
+        data[elements * 3 / 4] = findLimit + 1;
+    }
+    std::vector<int> queries(1000000);
+    for (int& query : queries) {
+        query = dis(gen);
+    }
+    auto aboveLimit = [findLimit](int n) { return n > findLimit; };
+
+    // Serial reference results and timings
+    Timings serial{};
+    std::vector<int> incremented = data;
+    serial.forEach = measureSeconds(1, [&] { std::for_each(incremented.begin(), incremented.end(), [](int& n) { n++; }); });
+    std::size_t serialFound = 0;
+    serial.findIf = measureSeconds(repeats, [&] {
+        serialFound = static_cast<std::size_t>(std::find_if(data.begin(), data.end(), aboveLimit) - data.begin());
+        doNotOptimize(serialFound);
+    });
+    std::vector<int> sortedAscending;
+    std::vector<int> sortedDescending;
+    serial.sortAscending = measureSortSeconds(repeats, data, sortedAscending,
+                                              [](std::vector<int>& v) { std::sort(v.begin(), v.end()); });
+    serial.sortDescending = measureSortSeconds(repeats, data, sortedDescending, [](std::vector<int>& v) {
+        std::sort(v.begin(), v.end(), std::greater<int>());
+    });
+    std::vector<char> serialHits(queries.size());
+    serial.binarySearch = measureSeconds(repeats, [&] {
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            serialHits[i] = std::binary_search(sortedAscending.begin(), sortedAscending.end(), queries[i]);
+        }
+        doNotOptimize(serialHits.data());
+    });
+
+    std::cout << "Elements: " << elements << ", binary_search queries: " << queries.size() << std::endl;
+    std::cout << std::left << std::setw(10) << "" << std::right << std::setw(8) << "threads" << std::setw(21)
+              << "for_each" << std::setw(21) << "find_if" << std::setw(21) << "sort" << std::setw(21)
+              << "sort greater" << std::setw(21) << "binary_search" << std::endl;
+    printRow("std", 1, serial, serial);
+
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(std::max<std::size_t>(1, maxThreads));
+
+    bool ok = true;
+    auto check = [&](bool same, const char* what, std::size_t threads) {
+        if (!same) {
+            std::cout << "MISMATCH: parallel " << what << " with " << threads << " threads" << std::endl;
+            ok = false;
+        }
+    };
+
+    std::vector<int> result;
+    for (std::size_t threads : threadCounts) {
+        ThreadPool pool(threads);
+        Timings parallel{};
+
+        result = data;
+        parallel.forEach = measureSeconds(1, [&] { parallelForEach(pool, result.begin(), result.end(), [](int& n) { n++; }); });
+        check(result == incremented, "for_each", threads);
+
+        std::size_t found = 0;
+        parallel.findIf = measureSeconds(repeats, [&] {
+            found = static_cast<std::size_t>(parallelFindIf(pool, data.begin(), data.end(), aboveLimit) - data.begin());
+            doNotOptimize(found);
+        });
+        check(found == serialFound, "find_if", threads);
+
+        parallel.sortAscending = measureSortSeconds(repeats, data, result, [&](std::vector<int>& v) {
+            parallelSort(pool, v.begin(), v.end());
+        });
+        check(result == sortedAscending, "sort", threads);
+        parallel.sortDescending = measureSortSeconds(repeats, data, result, [&](std::vector<int>& v) {
+            parallelSort(pool, v.begin(), v.end(), std::greater<int>());
+        });
+        check(result == sortedDescending, "sort greater", threads);
+
+        std::vector<char> hits(queries.size());
+        parallel.binarySearch = measureSeconds(repeats, [&] {
+            parallelBinarySearch(pool, sortedAscending.begin(), sortedAscending.end(), queries.begin(), queries.end(),
+                                 hits.begin());
+            doNotOptimize(hits.data());
+        });
+        check(hits == serialHits, "binary_search", threads);
+
+        printRow("parallel", threads, parallel, serial);
+    }
+
+    std::cout << (ok ? "All parallel results match the serial ones." : "Parallel results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
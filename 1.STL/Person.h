@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Name_Pool.h"
+
+// A simple class representing a person
+class Person {
+public:
+    Person(std::string name, int age) : name(std::move(name)), age(age) {}
+
+    // Shares the name with every other Person built from the same InternedName,
+    // so copying this Person never allocates
+    Person(InternedName name, int age) : interned(&name.str()), age(age) {}
+
+    // Getters and setters
+    // getName() returns a view, so reading or printing a name never copies it
+    std::string_view getName() const {
+        return interned != nullptr ? std::string_view(*interned) : std::string_view(name);
+    }
+
+    void setName(const std::string& name) {
+        this->name = name;
+        interned = nullptr;
+    }
+
+    void setName(InternedName name) {
+        this->name.clear();
+        interned = &name.str();
+    }
+
+    int getAge() const {
+        return age;
+    }
+
+    void setAge(int age) {
+        this->age = age;
+    }
+
+    // Overloaded comparison operators for sorting
+    bool operator<(const Person& other) const {
+        return age < other.age;
+    }
+
+private:
+    std::string name;                      // Own copy of the name (empty when interned)
+    const std::string* interned = nullptr; // Pooled name from the NamePool, if any
+    int age;
+};
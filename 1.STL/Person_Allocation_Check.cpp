@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <queue>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Allocation_Profiler.h"
+#include "Benchmark_Timer.h"
+#include "Flat_Set.h"
+#include "Node_Pool.h"
+#include "Person.h"
+#include "Person_Index.h"
+#include "Person_Output.h"
+#include "Person_Table.h"
+
+// Allocation-count checks for the iterate-and-print loops in Collections.cpp
+//
+// Each check runs one of the print loops the demos use (Person_Output.h) over the same kind
+// of container and fails if the loop allocated. Allocations are counted by
+// Allocation_Profiler.h, which replaces every form of operator new and delete (aligned and
+// nothrow included), with one profiler scope per check. The names are longer than the
+// small-string buffer of std::string, so a getter that copied the name would allocate on
+// every element; the control check makes sure such a copy is seen.
+//
+// Usage: Person_Allocation_Check   (exit code 0 if every check passes)
+
+// A stream buffer that throws the characters away, so printing needs no memory
+class DiscardBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+static int failures = 0;
+
+// Runs loop() in its own profiler scope and reports how many allocations it made.
+// name must be unique, since it also names the scope.
+template <typename Loop>
+void check(const char* name, Loop loop, bool expectAllocations = false) {
+    {
+        AllocationScope scope(name);
+        loop();
+    }
+    std::uint64_t allocations = AllocationProfiler::statsFor(name).allocations;
+    bool passed = expectAllocations ? allocations > 0 : allocations == 0;
+    std::cout << (passed ? "PASS " : "FAIL ") << name << ": " << allocations << " allocations" << std::endl;
+    if (!passed) {
+        ++failures;
+    }
+}
+
+int main() {
+    // Static, because the BufferedOutput is too big for the stack and must not outlive the stream
+    static DiscardBuffer discard;
+    static std::ostream stream(&discard);
+    static BufferedOutput out(stream);
+
+    const std::string alice = "Alice Abernathy-Longname";
+    const std::string bob = "Bob Bartholomew-Longname";
+    const std::string charlie = "Charlie Chamberlain-Longname";
+
+    // vectorExamples
+    std::vector<Person> people = {Person(alice, 30), Person(bob, 25), Person(charlie, 35)};
+    check("vectorExamples: writePeople", [&] { writePeople(out, people); });
+    // The same loop with a by-value name getter must allocate, or the checks prove nothing
+    check("control: copying each name", [&] {
+        for (const Person& person : people) {
+            std::string copy(person.getName());
+            out << copy;
+        }
+    }, true);
+
+    // personTableExamples
+    PersonTable table(people.begin(), people.end());
+    check("personTableExamples: writePeople", [&] { writePeople(out, table); });
+
+    // listExamples, with std::allocator and with the node pool
+    std::list<Person> personList(people.begin(), people.end());
+    check("listExamples: writePeople", [&] { writePeople(out, personList); });
+    NodePool pool;
+    std::pmr::list<Person> pooledList(people.begin(), people.end(), &pool);
+    check("listExamples: writePeople, pooled", [&] { writePeople(out, pooledList); });
+
+    // queueExamples (popping destroys elements but must not allocate)
+    std::queue<Person> personQueue;
+    for (const Person& person : people) {
+        personQueue.push(person);
+    }
+    check("queueExamples: writeAndPopPeople", [&] { writeAndPopPeople(out, personQueue); });
+
+    // setExamples
+    FlatSet<Person> personSet(people.begin(), people.end());
+    PersonIndex personIndex;
+    for (const Person& person : people) {
+        personIndex.insert(person);
+    }
+    check("setExamples: writePeople, FlatSet", [&] { writePeople(out, personSet); });
+    check("setExamples: writePeople, PersonIndex", [&] { writePeople(out, personIndex); });
+    check("setExamples: writePeople, age range", [&] { writePeople(out, personIndex.findByAgeRange(25, 35)); });
+
+    // Interned names: copying a Person copies a pointer, not the name
+    std::vector<Person> internedPeople(3, Person(internName(alice), 30));
+    check("interned names: vector copy allocates only its buffer", [&] {
+        std::vector<Person> copy = internedPeople;
+        doNotOptimize(copy);
+    }, true);
+    const std::uint64_t copyAllocations =
+        AllocationProfiler::statsFor("interned names: vector copy allocates only its buffer").allocations;
+    if (copyAllocations != 1) {
+        std::cout << "FAIL interned names: expected 1 allocation" << std::endl;
+        ++failures;
+    }
+
+    std::cout << (failures == 0 ? "All checks passed." : "Some checks failed.") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
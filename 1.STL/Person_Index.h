@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Flat_Hash_Map.h"
+#include "Person.h"
+
+// PersonIndex: a Person container with two indexes
+//
+// std::set<Person> orders people by Person::operator<, which only looks at the age, so
+// two different people with the same age count as duplicates and one of them is dropped.
+// Finding someone by name in such a set also means a linear scan.
+//
+// PersonIndex stores every Person once, in a slot array, and keeps two indexes over it:
+//  - a hash index on the name (FlatHashMap): O(1) lookup, names are unique keys
+//  - an ordered index on (age, slot): O(log n) age-range queries, equal ages allowed
+// People must be modified through setName/setAge on the container so that both indexes
+// stay consistent; that is why lookups only hand out const references.
+// The name index is keyed by views of the stored names, so every name is stored once; the
+// slots live in a std::deque, which never moves a Person once it is added.
+class PersonIndex {
+private:
+    using Slot = std::size_t;
+    using AgeIndex = std::set<std::pair<int, Slot>>;
+
+public:
+    // Iterates people in age order (equal ages in insertion-slot order)
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Person;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Person*;
+        using reference = const Person&;
+
+        const_iterator(const PersonIndex* index, AgeIndex::const_iterator position) : index(index), position(position) {}
+
+        reference operator*() const { return *index->people[position->second]; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() { ++position; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++position; return copy; }
+        const_iterator& operator--() { --position; return *this; }
+        const_iterator operator--(int) { const_iterator copy = *this; --position; return copy; }
+
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+
+    private:
+        const PersonIndex* index;
+        AgeIndex::const_iterator position;
+    };
+
+    // A pair of iterators usable in a range-based for loop
+    struct Range {
+        const_iterator first;
+        const_iterator last;
+
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    PersonIndex() = default;
+
+    // A copy indexes its own people, so the name keys are rebuilt to point at them
+    PersonIndex(const PersonIndex& other) : people(other.people), freeSlots(other.freeSlots), byAge(other.byAge) {
+        for (Slot slot = 0; slot < people.size(); ++slot) {
+            if (people[slot]) {
+                byName.emplace(people[slot]->getName(), slot);
+            }
+        }
+    }
+
+    PersonIndex& operator=(const PersonIndex& other) {
+        if (this != &other) {
+            PersonIndex copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // Moving keeps the deque's elements where they are, so the keys stay valid
+    PersonIndex(PersonIndex&&) = default;
+    PersonIndex& operator=(PersonIndex&&) = default;
+
+    // Iterators (age order)
+    const_iterator begin() const { return const_iterator(this, byAge.begin()); }
+    const_iterator end() const { return const_iterator(this, byAge.end()); }
+
+    // Capacity
+    std::size_t size() const { return byName.size(); }
+    bool empty() const { return byName.empty(); }
+
+    // Adds a person; returns false (and changes nothing) if the name is already taken.
+    // A person with an interned name is stored without copying the name.
+    bool insert(Person person) {
+        if (byName.contains(person.getName())) {
+            return false;
+        }
+        store(std::move(person));
+        return true;
+    }
+
+    bool emplace(std::string_view name, int age) {
+        if (byName.contains(name)) {
+            return false;
+        }
+        store(Person(std::string(name), age));
+        return true;
+    }
+
+    // O(1) lookup by name; returns nullptr if nobody has that name
+    const Person* findByName(std::string_view name) const {
+        auto it = byName.find(name);
+        return it == byName.end() ? nullptr : &*people[it->second];
+    }
+
+    bool containsName(std::string_view name) const {
+        return byName.contains(name);
+    }
+
+    // Everybody with minAge <= age <= maxAge, youngest first: O(log n) plus the result size
+    Range findByAgeRange(int minAge, int maxAge) const {
+        if (minAge > maxAge) {
+            return Range{end(), end()};
+        }
+        auto first = byAge.lower_bound({minAge, 0});
+        auto last = byAge.upper_bound({maxAge, std::numeric_limits<Slot>::max()});
+        return Range{const_iterator(this, first), const_iterator(this, last)};
+    }
+
+    std::size_t countByAgeRange(int minAge, int maxAge) const {
+        Range range = findByAgeRange(minAge, maxAge);
+        return static_cast<std::size_t>(std::distance(range.begin(), range.end()));
+    }
+
+    // Renames a person and moves the entry in the name index.
+    // Returns false if oldName does not exist or newName is already taken.
+    bool setName(std::string_view oldName, const std::string& newName) {
+        auto it = byName.find(oldName);
+        if (it == byName.end() || (oldName != newName && byName.contains(newName))) {
+            return false;
+        }
+        Slot slot = it->second;
+        byName.erase(it);
+        people[slot]->setName(newName);
+        byName.emplace(people[slot]->getName(), slot);
+        return true;
+    }
+
+    // Changes a person's age and moves the entry in the age index.
+    // Returns false if nobody has that name.
+    bool setAge(std::string_view name, int age) {
+        auto it = byName.find(name);
+        if (it == byName.end()) {
+            return false;
+        }
+        Slot slot = it->second;
+        Person& person = *people[slot];
+        byAge.erase({person.getAge(), slot});
+        byAge.emplace(age, slot);
+        person.setAge(age);
+        return true;
+    }
+
+    // Removes a person from both indexes; the slot is reused by the next insert
+    bool erase(std::string_view name) {
+        auto it = byName.find(name);
+        if (it == byName.end()) {
+            return false;
+        }
+        Slot slot = it->second;
+        byName.erase(it);
+        byAge.erase({people[slot]->getAge(), slot});
+        people[slot].reset();
+        freeSlots.push_back(slot);
+        return true;
+    }
+
+    void clear() {
+        people.clear();
+        freeSlots.clear();
+        byName.clear();
+        byAge.clear();
+    }
+
+private:
+    // Puts person into a free slot and indexes it under its stored name
+    void store(Person person) {
+        Slot slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            people[slot].emplace(std::move(person));
+        } else {
+            slot = people.size();
+            people.emplace_back(std::move(person));
+        }
+        byName.emplace(people[slot]->getName(), slot);
+        byAge.emplace(people[slot]->getAge(), slot);
+    }
+
+    std::deque<std::optional<Person>> people;    // Empty slots are listed in freeSlots
+    std::vector<Slot> freeSlots;
+    FlatHashMap<std::string_view, Slot> byName;  // Views of the names in people
+    AgeIndex byAge;
+};
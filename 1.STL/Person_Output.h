@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Buffered_Output.h"
+
+// Print loops for containers of people, shared by the Collections.cpp demos and
+// Person_Allocation_Check.cpp, so that the check runs the same loops the demos do
+
+// Writes "name (age) " for every element of people: Person, PersonTable rows, snapshot
+// records or anything else with getName() and getAge()
+template <typename Range>
+void writePeople(BufferedOutput& out, const Range& people) {
+    for (const auto& person : people) {
+        out << person.getName() << " (" << person.getAge() << ") ";
+    }
+}
+
+// The same for a std::queue, which can only be read by popping it
+template <typename Queue>
+void writeAndPopPeople(BufferedOutput& out, Queue& people) {
+    while (!people.empty()) {
+        const auto& person = people.front();
+        out << person.getName() << " (" << person.getAge() << ") ";
+        people.pop();
+    }
+}
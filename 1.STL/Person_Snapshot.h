@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Mapped_File.h"
+
+// Person snapshots: a compact binary file format that can be memory-mapped and read in place
+//
+// Loading millions of people with push_back(Person(...)) parses and allocates once per
+// record. A snapshot is laid out so that a reader can map the file and answer
+// getName(i)/getAge(i) directly from the mapped bytes, without building any Person:
+//
+//     offset 0    Header (64 bytes): magic, version, record count, blob size, checksum
+//     64          ages:    int32  x count     fixed-width age column
+//     ...         offsets: uint64 x (count+1) name i is blob[offsets[i], offsets[i+1])
+//     ...         names:   the name bytes, back to back (not null-terminated)
+//
+// Sections start on 8-byte boundaries. The checksum covers the header up to the checksum
+// field and everything after the header.
+// Integers are stored little-endian, the native order of every platform we build for.
+
+struct PersonSnapshotHeader {
+    char magic[8];              // "PSNAP01\0"
+    std::uint32_t version;
+    std::uint32_t headerSize;   // sizeof(PersonSnapshotHeader)
+    std::uint64_t count;        // Number of records
+    std::uint64_t agesOffset;   // File offsets of the three sections
+    std::uint64_t offsetsOffset;
+    std::uint64_t namesOffset;
+    std::uint64_t namesSize;    // Size of the name blob in bytes
+    std::uint64_t checksum;     // personSnapshotChecksum() of the header fields above and the body
+};
+
+static_assert(sizeof(PersonSnapshotHeader) == 64, "The snapshot header must stay 64 bytes");
+
+constexpr char kPersonSnapshotMagic[8] = {'P', 'S', 'N', 'A', 'P', '0', '1', '\0'};
+constexpr std::uint32_t kPersonSnapshotVersion = 2; // 1 did not checksum the header
+
+// 64-bit checksum that consumes 8 bytes per step (FNV-style multiply/xor with a final mix)
+inline std::uint64_t snapshotChecksum(const unsigned char* data, std::size_t size, std::uint64_t hash = 0xcbf29ce484222325ull) {
+    const std::uint64_t prime = 0x100000001b3ull;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash ^ (hash >> 32);
+}
+
+// Checksum of a whole snapshot: every header field before the checksum itself, then the body
+inline std::uint64_t personSnapshotChecksum(const PersonSnapshotHeader& header, const unsigned char* body,
+                                            std::size_t bodySize) {
+    const std::uint64_t headerHash =
+        snapshotChecksum(reinterpret_cast<const unsigned char*>(&header), offsetof(PersonSnapshotHeader, checksum));
+    return snapshotChecksum(body, bodySize, headerHash);
+}
+
+// How the writer reads a name and an age from the element types used in Collections.cpp:
+// anything with getName()/getAge() (Person, PersonTable rows, ...) or a (name, age) pair
+template <typename T>
+auto snapshotName(const T& element) -> decltype(std::string_view(element.getName())) {
+    return element.getName();
+}
+
+template <typename T>
+auto snapshotAge(const T& element) -> decltype(static_cast<int>(element.getAge())) {
+    return element.getAge();
+}
+
+template <typename Name, typename Age>
+std::string_view snapshotName(const std::pair<Name, Age>& element) {
+    return element.first;
+}
+
+template <typename Name, typename Age>
+int snapshotAge(const std::pair<Name, Age>& element) {
+    return static_cast<int>(element.second);
+}
+
+// Writes every element of a container (vector, list, set, map, PersonTable, ...) to path.
+// Throws std::runtime_error if the file cannot be written.
+template <typename Container>
+void writePersonSnapshot(const std::string& path, const Container& people) {
+    std::vector<std::int32_t> ages;
+    std::vector<std::uint64_t> offsets;
+    std::string names;
+    offsets.push_back(0);
+    for (const auto& person : people) {
+        ages.push_back(static_cast<std::int32_t>(snapshotAge(person)));
+        names.append(snapshotName(person));
+        offsets.push_back(names.size());
+    }
+
+    auto align8 = [](std::uint64_t offset) { return (offset + 7) & ~std::uint64_t(7); };
+
+    PersonSnapshotHeader header{};
+    std::memcpy(header.magic, kPersonSnapshotMagic, sizeof(header.magic));
+    header.version = kPersonSnapshotVersion;
+    header.headerSize = sizeof(PersonSnapshotHeader);
+    header.count = ages.size();
+    header.agesOffset = sizeof(PersonSnapshotHeader);
+    header.offsetsOffset = align8(header.agesOffset + ages.size() * sizeof(std::int32_t));
+    header.namesOffset = header.offsetsOffset + offsets.size() * sizeof(std::uint64_t);
+    header.namesSize = names.size();
+
+    // Assemble the body once, so the checksum is computed over exactly the bytes written
+    std::vector<unsigned char> body(header.namesOffset + names.size() - sizeof(PersonSnapshotHeader), 0);
+    unsigned char* base = body.data() - sizeof(PersonSnapshotHeader);
+    if (!ages.empty()) {
+        std::memcpy(base + header.agesOffset, ages.data(), ages.size() * sizeof(std::int32_t));
+    }
+    std::memcpy(base + header.offsetsOffset, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+    std::memcpy(base + header.namesOffset, names.data(), names.size());
+    header.checksum = personSnapshotChecksum(header, body.data(), body.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+    if (!file) {
+        throw std::runtime_error("writePersonSnapshot: cannot write " + path);
+    }
+}
+
+// std::queue cannot be iterated, so its elements are drained from a copy
+template <typename T, typename Sequence>
+void writePersonSnapshot(const std::string& path, std::queue<T, Sequence> queue) {
+    std::vector<T> elements;
+    while (!queue.empty()) {
+        elements.push_back(std::move(queue.front()));
+        queue.pop();
+    }
+    writePersonSnapshot(path, elements);
+}
+
+// A read-only, zero-copy view of a snapshot file
+//
+// The file is memory-mapped with Mapped_File.h; names are returned as std::string_views into
+// the mapping and ages are read from the mapped column, so nothing is parsed or allocated
+// per record.
+// Opening checks that every name offset lies inside the name blob (one pass over the
+// offsets column) and, if asked, verifies the checksum (one pass over the file). The views
+// stay valid as long as the PersonSnapshot is alive.
+class PersonSnapshot {
+public:
+    // One record, with the same getters as Person
+    class Record {
+    public:
+        Record(std::string_view name, int age) : name(name), age(age) {}
+
+        std::string_view getName() const { return name; }
+        int getAge() const { return age; }
+
+    private:
+        std::string_view name;
+        int age;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Record;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Record;
+
+        const_iterator(const PersonSnapshot* snapshot, std::size_t index) : snapshot(snapshot), index(index) {}
+
+        Record operator*() const { return (*snapshot)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index; return copy; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator& operator+=(difference_type n) { index += n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(snapshot, index + n); }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const PersonSnapshot* snapshot;
+        std::size_t index;
+    };
+
+    // Maps the file and validates the header; with verifyChecksum the whole body is
+    // checked as well. Throws std::runtime_error on any problem.
+    explicit PersonSnapshot(const std::string& path, bool verifyChecksum = true) : file(path) {
+        validate(verifyChecksum);
+    }
+
+    PersonSnapshot(const PersonSnapshot&) = delete;
+    PersonSnapshot& operator=(const PersonSnapshot&) = delete;
+
+    PersonSnapshot(PersonSnapshot&& other) noexcept
+        : file(std::move(other.file)), count(std::exchange(other.count, 0)), ages(other.ages), offsets(other.offsets),
+          names(other.names) {}
+
+    PersonSnapshot& operator=(PersonSnapshot&& other) noexcept {
+        if (this != &other) {
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return static_cast<std::size_t>(count); }
+    bool empty() const { return count == 0; }
+
+    std::string_view getName(std::size_t i) const {
+        return std::string_view(names + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i]));
+    }
+
+    int getAge(std::size_t i) const {
+        return ages[i];
+    }
+
+    Record operator[](std::size_t i) const { return Record(getName(i), getAge(i)); }
+
+    Record at(std::size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("PersonSnapshot::at: index out of range");
+        }
+        return (*this)[i];
+    }
+
+    // The whole age column, e.g. for scans
+    const std::int32_t* ageData() const { return ages; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    void validate(bool verifyChecksum) {
+        const unsigned char* data = file.data();
+        const std::size_t fileSize = file.size();
+        if (fileSize < sizeof(PersonSnapshotHeader)) {
+            throw std::runtime_error("PersonSnapshot: file too small");
+        }
+        PersonSnapshotHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kPersonSnapshotMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("PersonSnapshot: not a Person snapshot");
+        }
+        if (header.version != kPersonSnapshotVersion || header.headerSize != sizeof(PersonSnapshotHeader)) {
+            throw std::runtime_error("PersonSnapshot: unsupported version");
+        }
+        // Every section must lie inside the file, in order. Each field is bounded by the file
+        // size before it is used in a product or sum, so none of the arithmetic can wrap.
+        if (header.agesOffset != sizeof(PersonSnapshotHeader) || header.offsetsOffset > fileSize ||
+            header.namesOffset > fileSize || header.namesSize > fileSize ||
+            header.count > (fileSize - sizeof(PersonSnapshotHeader)) / sizeof(std::int32_t)) {
+            throw std::runtime_error("PersonSnapshot: corrupt header");
+        }
+        const std::uint64_t agesEnd = header.agesOffset + header.count * sizeof(std::int32_t);
+        if (header.offsetsOffset < agesEnd || header.offsetsOffset % 8 != 0 ||
+            header.count >= (fileSize - header.offsetsOffset) / sizeof(std::uint64_t) ||
+            header.namesOffset < header.offsetsOffset + (header.count + 1) * sizeof(std::uint64_t) ||
+            header.namesSize != fileSize - header.namesOffset) {
+            throw std::runtime_error("PersonSnapshot: corrupt header");
+        }
+        if (verifyChecksum &&
+            personSnapshotChecksum(header, data + sizeof(PersonSnapshotHeader), fileSize - sizeof(PersonSnapshotHeader)) !=
+                header.checksum) {
+            throw std::runtime_error("PersonSnapshot: checksum mismatch");
+        }
+
+        count = header.count;
+        ages = reinterpret_cast<const std::int32_t*>(data + header.agesOffset);
+        offsets = reinterpret_cast<const std::uint64_t*>(data + header.offsetsOffset);
+        names = reinterpret_cast<const char*>(data + header.namesOffset);
+        // getName(i) trusts offsets[i] <= offsets[i + 1] <= namesSize, so check all of them
+        if (offsets[0] != 0 || offsets[count] != header.namesSize) {
+            throw std::runtime_error("PersonSnapshot: corrupt name offsets");
+        }
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (offsets[i] > offsets[i + 1]) {
+                throw std::runtime_error("PersonSnapshot: corrupt name offsets");
+            }
+        }
+    }
+
+    void moveFrom(PersonSnapshot& other) {
+        file = std::move(other.file);
+        count = std::exchange(other.count, 0);
+        ages = other.ages;
+        offsets = other.offsets;
+        names = other.names;
+    }
+
+    MappedFile file;
+    std::uint64_t count = 0;
+    const std::int32_t* ages = nullptr;
+    const std::uint64_t* offsets = nullptr;
+    const char* names = nullptr;
+};
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Person.h"
+#include "Person_Snapshot.h"
+#include "Person_Table.h"
+
+// Startup cost of getting N people into memory: rebuilding a std::vector<Person> with
+// push_back(Person(...)) from a snapshot versus opening the snapshot as a mapped view.
+// Both then read every name and age once, so the work done per record is comparable.
+//
+// Usage: Person_Snapshot_Benchmark [records] [file]   (defaults: 10000000, people.snapshot)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+int main(int argc, char** argv) {
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = argc > 2 ? argv[2] : "people.snapshot";
+
+    // Names are longer than the small-string buffer, as real names often are
+    PersonTable table;
+    table.reserve(records);
+    for (std::size_t i = 0; i < records; ++i) {
+        table.emplace_back("Person number " + std::to_string(i), static_cast<int>(i % 100));
+    }
+    double writeSeconds = measureSeconds(1, [&] { writePersonSnapshot(path, table); });
+
+    long long expected = 0;
+    std::size_t expectedChars = 0;
+    for (const auto& person : table) {
+        expected += person.getAge();
+        expectedChars += person.getName().size();
+    }
+
+    long long sum = 0;
+    std::size_t chars = 0;
+    double rebuildSeconds = measureSeconds(3, [&] {
+        PersonSnapshot snapshot(path, false);
+        std::vector<Person> people;
+        people.reserve(snapshot.size());
+        for (std::size_t i = 0; i < snapshot.size(); ++i) {
+            people.push_back(Person(std::string(snapshot.getName(i)), snapshot.getAge(i)));
+        }
+        sum = 0;
+        chars = 0;
+        for (const Person& person : people) {
+            sum += person.getAge();
+            chars += person.getName().size();
+        }
+    });
+    bool rebuildOk = sum == expected && chars == expectedChars;
+
+    auto readView = [&](bool verify) {
+        PersonSnapshot snapshot(path, verify);
+        sum = 0;
+        chars = 0;
+        for (const auto& person : snapshot) {
+            sum += person.getAge();
+            chars += person.getName().size();
+        }
+    };
+    double viewSeconds = measureSeconds(3, [&] { readView(false); });
+    bool viewOk = sum == expected && chars == expectedChars;
+    double verifiedSeconds = measureSeconds(3, [&] { readView(true); });
+
+    std::remove(path.c_str());
+
+    std::cout << "Records: " << records << std::endl;
+    std::cout << "Write snapshot:                    " << writeSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "Rebuild std::vector<Person>:       " << rebuildSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "Mapped view:                       " << viewSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "Mapped view, checksum verified:    " << verifiedSeconds * 1e3 << " ms" << std::endl;
+
+    if (!rebuildOk || !viewOk) {
+        std::cout << "Mismatch between written and loaded records!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
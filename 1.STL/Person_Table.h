@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Person.h"
+
+// PersonTable: a structure-of-arrays (columnar) alternative to std::vector<Person>
+//
+// std::vector<Person> stores every name right next to its age, so a scan that only
+// looks at ages still pulls every std::string through the cache. PersonTable keeps
+// names and ages in two separate columns: an age scan only touches a dense array of
+// ints, which the compiler can vectorize and which streams at memory bandwidth.
+class PersonTable {
+public:
+    // A lightweight, read-only view of one row. It has the same getters as Person,
+    // so the print loops written for std::vector<Person> work unchanged.
+    class Row {
+    public:
+        Row(const std::string& name, int age) : name(name), age(age) {}
+
+        std::string_view getName() const {
+            return name;
+        }
+
+        int getAge() const {
+            return age;
+        }
+
+        Person toPerson() const {
+            return Person(name, age);
+        }
+
+    private:
+        const std::string& name;
+        int age;
+    };
+
+    // Random-access iterator over row positions, dereferencing to a Row
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Row;
+
+        const_iterator(const PersonTable* table, std::size_t index) : table(table), index(index) {}
+
+        Row operator*() const { return (*table)[index]; }
+        Row operator[](difference_type n) const { return (*table)[index + n]; }
+
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index; return copy; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator operator--(int) { const_iterator copy = *this; --index; return copy; }
+        const_iterator& operator+=(difference_type n) { index += n; return *this; }
+        const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(table, index + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(table, index - n); }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator<(const const_iterator& other) const { return index < other.index; }
+        bool operator>(const const_iterator& other) const { return index > other.index; }
+        bool operator<=(const const_iterator& other) const { return index <= other.index; }
+        bool operator>=(const const_iterator& other) const { return index >= other.index; }
+
+        // Position of the iterator inside the table (used by insert/erase)
+        std::size_t position() const { return index; }
+
+    private:
+        const PersonTable* table;
+        std::size_t index;
+    };
+
+    PersonTable() = default;
+
+    // Builds a table from any range of Person objects
+    template <typename InputIt>
+    PersonTable(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    // Iterators
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Capacity
+    std::size_t size() const { return ages.size(); }
+    bool empty() const { return ages.empty(); }
+    std::size_t capacity() const { return std::min(names.capacity(), ages.capacity()); }
+
+    void reserve(std::size_t n) {
+        names.reserve(n);
+        ages.reserve(n);
+    }
+
+    void shrink_to_fit() {
+        names.shrink_to_fit();
+        ages.shrink_to_fit();
+    }
+
+    // Element access
+    Row operator[](std::size_t i) const { return Row(names[i], ages[i]); }
+
+    Row at(std::size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("PersonTable::at: index out of range");
+        }
+        return (*this)[i];
+    }
+
+    Row front() const { return (*this)[0]; }
+    Row back() const { return (*this)[size() - 1]; }
+
+    // Direct access to the columns, e.g. to hand the ages to another algorithm
+    const std::string* nameData() const { return names.data(); }
+    const int* ageData() const { return ages.data(); }
+
+    void setName(std::size_t i, const std::string& name) { names[i] = name; }
+    void setAge(std::size_t i, int age) { ages[i] = age; }
+
+    // Modifiers
+    //
+    // The two columns always have the same length: if the second column throws
+    // (bad_alloc), the change already made to the first one is undone.
+    void push_back(const Person& person) {
+        emplace_back(std::string(person.getName()), person.getAge());
+    }
+
+    void emplace_back(std::string name, int age) {
+        names.push_back(std::move(name));
+        try {
+            ages.push_back(age);
+        } catch (...) {
+            names.pop_back();
+            throw;
+        }
+    }
+
+    void pop_back() {
+        names.pop_back();
+        ages.pop_back();
+    }
+
+    const_iterator insert(const_iterator pos, const Person& person) {
+        return emplace(pos, std::string(person.getName()), person.getAge());
+    }
+
+    const_iterator emplace(const_iterator pos, std::string name, int age) {
+        std::size_t i = pos.position();
+        names.insert(names.begin() + i, std::move(name));
+        try {
+            ages.insert(ages.begin() + i, age);
+        } catch (...) {
+            names.erase(names.begin() + i);
+            throw;
+        }
+        return const_iterator(this, i);
+    }
+
+    // Cannot throw: erasing only moves strings and ints down
+    const_iterator erase(const_iterator pos) {
+        std::size_t i = pos.position();
+        names.erase(names.begin() + i);
+        ages.erase(ages.begin() + i);
+        return const_iterator(this, i);
+    }
+
+    void assign(std::size_t count, const Person& person) {
+        reserve(count);
+        ages.assign(count, person.getAge()); // Cannot throw once reserved
+        try {
+            names.assign(count, std::string(person.getName()));
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    void swap(PersonTable& other) noexcept {
+        names.swap(other.names);
+        ages.swap(other.ages);
+    }
+
+    void clear() {
+        names.clear();
+        ages.clear();
+    }
+
+    // Column scans
+    //
+    // These loops only read the age column and are written without branches, so
+    // the compiler turns them into SIMD code (build with -O3 or -O2 -ftree-vectorize).
+
+    // Number of people with minAge <= age <= maxAge
+    std::size_t countAgesBetween(int minAge, int maxAge) const {
+        if (minAge > maxAge) {
+            return 0;
+        }
+        // One unsigned compare checks both bounds: values below minAge wrap around
+        const std::uint32_t lo = static_cast<std::uint32_t>(minAge);
+        const std::uint32_t width = static_cast<std::uint32_t>(maxAge) - lo;
+        const int* data = ages.data();
+        const std::size_t n = ages.size();
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            count += (static_cast<std::uint32_t>(data[i]) - lo) <= width;
+        }
+        return count;
+    }
+
+    // Row indexes of the people with minAge <= age <= maxAge, in table order
+    std::vector<std::size_t> filterAgesBetween(int minAge, int maxAge) const {
+        std::vector<std::size_t> result;
+        if (minAge > maxAge) {
+            return result;
+        }
+        const std::uint32_t lo = static_cast<std::uint32_t>(minAge);
+        const std::uint32_t width = static_cast<std::uint32_t>(maxAge) - lo;
+        const int* data = ages.data();
+        const std::size_t n = ages.size();
+        // Branchless compaction: always write the index, only advance on a match
+        result.resize(n + 1);
+        std::size_t* out = result.data();
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[count] = i;
+            count += (static_cast<std::uint32_t>(data[i]) - lo) <= width;
+        }
+        result.resize(count);
+        return result;
+    }
+
+    // Sum of all ages, accumulated in 64 bits so tens of millions of rows cannot overflow
+    long long sumAges() const {
+        const int* data = ages.data();
+        const std::size_t n = ages.size();
+        long long sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    double averageAge() const {
+        return empty() ? 0.0 : static_cast<double>(sumAges()) / static_cast<double>(size());
+    }
+
+    // Smallest age, or INT_MAX for an empty table
+    int minAge() const {
+        const int* data = ages.data();
+        const std::size_t n = ages.size();
+        int result = std::numeric_limits<int>::max();
+        for (std::size_t i = 0; i < n; ++i) {
+            result = std::min(result, data[i]);
+        }
+        return result;
+    }
+
+    // Largest age, or INT_MIN for an empty table
+    int maxAge() const {
+        const int* data = ages.data();
+        const std::size_t n = ages.size();
+        int result = std::numeric_limits<int>::min();
+        for (std::size_t i = 0; i < n; ++i) {
+            result = std::max(result, data[i]);
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::string> names;
+    std::vector<int> ages;
+};
+
+inline void swap(PersonTable& a, PersonTable& b) noexcept {
+    a.swap(b);
+}
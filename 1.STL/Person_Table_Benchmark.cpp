@@ -0,0 +1,90 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Person.h"
+#include "Person_Table.h"
+
+// Compares age scans over std::vector<Person> (array of structs)
+// with the same scans over PersonTable (structure of arrays).
+//
+// Usage: Person_Table_Benchmark [rows]   (default: 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+int main(int argc, char** argv) {
+    std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int repeats = 5;
+
+    // Build the same data set in both layouts
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> ageDis(0, 99);
+    const char* names[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Frank", "Grace", "Hank"};
+
+    std::vector<Person> people;
+    PersonTable table;
+    people.reserve(rows);
+    table.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        std::string name = names[i % 8];
+        int age = ageDis(gen);
+        people.push_back(Person(name, age));
+        table.emplace_back(name, age);
+    }
+
+    std::cout << "Rows: " << rows << std::endl;
+
+    // Count people aged 18 to 65
+    std::size_t vectorCount = 0;
+    double vectorTime = measureSeconds(repeats, [&] {
+        std::size_t count = 0;
+        for (const Person& person : people) {
+            count += person.getAge() >= 18 && person.getAge() <= 65;
+        }
+        vectorCount = count;
+        doNotOptimize(count);
+    });
+
+    std::size_t tableCount = 0;
+    double tableTime = measureSeconds(repeats, [&] {
+        tableCount = table.countAgesBetween(18, 65);
+        doNotOptimize(tableCount);
+    });
+
+    // Sum of all ages
+    long long vectorSum = 0;
+    double vectorSumTime = measureSeconds(repeats, [&] {
+        long long sum = 0;
+        for (const Person& person : people) {
+            sum += person.getAge();
+        }
+        vectorSum = sum;
+        doNotOptimize(sum);
+    });
+
+    long long tableSum = 0;
+    double tableSumTime = measureSeconds(repeats, [&] {
+        tableSum = table.sumAges();
+        doNotOptimize(tableSum);
+    });
+
+    if (vectorCount != tableCount || vectorSum != tableSum) {
+        std::cout << "Mismatch between std::vector<Person> and PersonTable results!" << std::endl;
+        return 1;
+    }
+
+    // Bandwidth is reported for the bytes each layout actually has to stream
+    auto report = [rows](const char* label, double seconds, std::size_t bytesPerRow) {
+        double gbPerSecond = static_cast<double>(rows * bytesPerRow) / seconds / 1e9;
+        std::cout << label << seconds * 1e3 << " ms (" << gbPerSecond << " GB/s)" << std::endl;
+    };
+
+    report("countAgesBetween, std::vector<Person>: ", vectorTime, sizeof(Person));
+    report("countAgesBetween, PersonTable:         ", tableTime, sizeof(int));
+    report("sumAges, std::vector<Person>:          ", vectorSumTime, sizeof(Person));
+    report("sumAges, PersonTable:                  ", tableSumTime, sizeof(int));
+
+    return 0;
+}
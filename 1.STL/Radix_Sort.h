@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// LSD radix sort for std::vector<int>, ascending or descending
+//
+// std::sort does about n*log2(n) comparisons; for 32-bit keys a radix sort does four
+// counting passes of one byte each, no matter how large n gets:
+//     std::vector<int> scratch;                             // reused between calls
+//     radixSort(vec, scratch);                              // same as std::sort(vec)
+//     radixSort(vec, scratch, SortOrder::Descending);       // same as std::sort with std::greater<int>()
+// Negative numbers are handled by flipping the sign bit of each key, and descending order
+// by inverting the whole key, so neither needs a comparator.
+//
+// One read of the data builds the histograms of all four bytes. A byte that is the same in
+// every element (the top bytes of small numbers, or data with few distinct values) gives a
+// pass that would not move anything, so it is skipped, and input that is already in order
+// is detected up front and left alone.
+// Ranges shorter than kRadixSortThreshold are sorted by std::sort, which wins there
+// because clearing and scanning the 4 x 256 counters costs more than the sort itself.
+
+enum class SortOrder { Ascending, Descending };
+
+// Below this many elements radixSort calls std::sort
+constexpr std::size_t kRadixSortThreshold = 256;
+
+// Unsigned key whose unsigned order is the requested order of the ints
+inline std::uint32_t radixKey(int value, SortOrder order) {
+    std::uint32_t key = static_cast<std::uint32_t>(value) ^ 0x80000000u;
+    return order == SortOrder::Ascending ? key : ~key;
+}
+
+// Sorts [first, last) using scratch, which must have room for (last - first) ints.
+// The result always ends up in [first, last); scratch is left with unspecified contents.
+inline void radixSort(int* first, int* last, int* scratch, SortOrder order = SortOrder::Ascending) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < kRadixSortThreshold) {
+        if (order == SortOrder::Ascending) {
+            std::sort(first, last);
+        } else {
+            std::sort(first, last, std::greater<int>());
+        }
+        return;
+    }
+
+    // Already ordered input (a common case, and the best one for std::sort) needs no passes;
+    // on unordered input this check stops within the first few elements
+    if (order == SortOrder::Ascending ? std::is_sorted(first, last) : std::is_sorted(first, last, std::greater<int>())) {
+        return;
+    }
+
+    std::size_t counts[4][256] = {};
+    for (const int* p = first; p != last; ++p) {
+        std::uint32_t key = radixKey(*p, order);
+        ++counts[0][key & 0xff];
+        ++counts[1][(key >> 8) & 0xff];
+        ++counts[2][(key >> 16) & 0xff];
+        ++counts[3][key >> 24];
+    }
+
+    int* source = first;
+    int* target = scratch;
+    for (int pass = 0; pass < 4; ++pass) {
+        std::size_t* count = counts[pass];
+        const unsigned shift = 8u * static_cast<unsigned>(pass);
+        if (count[(radixKey(*source, order) >> shift) & 0xff] == n) {
+            continue; // Every element has the same byte here
+        }
+        // Turn the counts into the start position of each bucket
+        std::size_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            std::size_t size = count[bucket];
+            count[bucket] = offset;
+            offset += size;
+        }
+        for (const int* p = source; p != source + n; ++p) {
+            target[count[(radixKey(*p, order) >> shift) & 0xff]++] = *p;
+        }
+        std::swap(source, target);
+    }
+    if (source != first) {
+        std::memcpy(first, source, n * sizeof(int));
+    }
+}
+
+// Sorts values, growing scratch to values.size() if needed. Passing the same scratch
+// vector to repeated calls avoids allocating a buffer for every sort.
+inline void radixSort(std::vector<int>& values, std::vector<int>& scratch, SortOrder order = SortOrder::Ascending) {
+    if (values.size() < kRadixSortThreshold) {
+        radixSort(values.data(), values.data() + values.size(), nullptr, order);
+        return;
+    }
+    if (scratch.size() < values.size()) {
+        scratch.resize(values.size());
+    }
+    radixSort(values.data(), values.data() + values.size(), scratch.data(), order);
+}
+
+// Sorts values with a temporary scratch buffer
+inline void radixSort(std::vector<int>& values, SortOrder order = SortOrder::Ascending) {
+    std::vector<int> scratch;
+    radixSort(values, scratch, order);
+}
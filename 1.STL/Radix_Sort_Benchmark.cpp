@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Radix_Sort.h"
+
+// Compares radixSort from Radix_Sort.h with std::sort, ascending and with std::greater<int>(),
+// on random ints (negative ones included), already sorted input and input with only 16
+// distinct values, for 1e3 to maxN elements. Each result is checked against std::sort;
+// any difference is reported and makes the program exit with status 1.
+//
+// Usage: Radix_Sort_Benchmark [maxN]   (default: 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 -march=native
+
+std::vector<int> makeInput(const char* kind, std::size_t n, std::mt19937& gen) {
+    std::vector<int> data(n);
+    std::uniform_int_distribution<int> dis(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    for (int& value : data) {
+        value = dis(gen);
+    }
+    if (kind[0] == 's') {
+        std::sort(data.begin(), data.end());
+    } else if (kind[0] == 'f') {
+        std::uniform_int_distribution<int> few(-8, 7);
+        for (int& value : data) {
+            value = few(gen) * 1000;
+        }
+    }
+    return data;
+}
+
+int main(int argc, char** argv) {
+    std::size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int repeats = 3;
+    const char* kinds[] = {"random", "sorted", "few-unique"};
+
+    std::mt19937 gen(42);
+    std::vector<int> expected;
+    std::vector<int> result;
+    std::vector<int> scratch;
+    bool ok = true;
+
+    std::cout << std::left << std::setw(12) << "input" << std::right << std::setw(10) << "n" << std::setw(14)
+              << "std::sort" << std::setw(14) << "radixSort" << std::setw(9) << "speedup" << std::setw(14)
+              << "std greater" << std::setw(14) << "radix desc" << std::setw(9) << "speedup" << std::endl;
+    for (const char* kind : kinds) {
+        for (std::size_t n = 1000; n <= maxN; n *= 10) {
+            std::vector<int> data = makeInput(kind, n, gen);
+            const double perElement = 1e9 / static_cast<double>(n);
+
+            double stdAscending = measureSortSeconds(repeats, data, expected, [](std::vector<int>& v) {
+                std::sort(v.begin(), v.end());
+            });
+            double radixAscending = measureSortSeconds(repeats, data, result, [&](std::vector<int>& v) {
+                radixSort(v, scratch);
+            });
+            if (result != expected) {
+                std::cout << "MISMATCH: ascending radixSort on " << kind << " input, n = " << n << std::endl;
+                ok = false;
+            }
+
+            double stdDescending = measureSortSeconds(repeats, data, expected, [](std::vector<int>& v) {
+                std::sort(v.begin(), v.end(), std::greater<int>());
+            });
+            double radixDescending = measureSortSeconds(repeats, data, result, [&](std::vector<int>& v) {
+                radixSort(v, scratch, SortOrder::Descending);
+            });
+            if (result != expected) {
+                std::cout << "MISMATCH: descending radixSort on " << kind << " input, n = " << n << std::endl;
+                ok = false;
+            }
+
+            std::cout << std::left << std::setw(12) << kind << std::right << std::setw(10) << n << std::fixed
+                      << std::setprecision(2) << std::setw(11) << stdAscending * perElement << " ns"
+                      << std::setw(11) << radixAscending * perElement << " ns" << std::setw(8)
+                      << stdAscending / radixAscending << "x" << std::setw(11) << stdDescending * perElement
+                      << " ns" << std::setw(11) << radixDescending * perElement << " ns" << std::setw(8)
+                      << stdDescending / radixDescending << "x" << std::endl;
+        }
+    }
+
+    std::cout << "Times are per element. "
+              << (ok ? "All radixSort results match std::sort." : "radixSort results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
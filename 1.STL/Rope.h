@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Rope: a text buffer with logarithmic-time edits and O(1) snapshots
+//
+// std::string::insert/erase/replace move every byte after the edit, so millions of small
+// edits on a multi-MB document are millions of multi-MB memmoves. Rope keeps the text as a
+// sequence of chunks of at most kMaxChunk bytes in a balanced tree (a treap keyed by
+// position), so an edit only touches the O(log n) nodes on one path:
+//     Rope text("Hello World");
+//     text.replace(6, 5, "C++");          // same arguments as the std::string members
+//     text.erase(5, 3);
+//     text.insert(5, " Beautiful");
+//     Rope before = text;                 // snapshot: shares every node, O(1)
+//     std::size_t pos = text.find("World");
+//
+// Nodes are immutable and shared through std::shared_ptr. An edit copies the nodes on its
+// path and leaves the old ones alone, so copies of a Rope are snapshots that stay valid and
+// unchanged whatever happens to the original. Small edits inside one chunk rewrite only that
+// chunk instead of cutting it, which keeps the number of chunks from growing with every edit.
+//
+// Positions are byte offsets, as in std::string, and out-of-range positions throw
+// std::out_of_range. Reading a single character costs O(log n); use forEachChunk() or
+// toString() to read long stretches.
+class Rope {
+public:
+    static constexpr std::size_t npos = std::string::npos;
+
+    // Chunk size: large enough that the tree stays small, small enough that rewriting a
+    // chunk on an edit is cheap
+    static constexpr std::size_t kMaxChunk = 1024;
+
+    // Chunks are built half full so that small edits fit into the chunk they land in
+    static constexpr std::size_t kBuildChunk = kMaxChunk / 2;
+
+    Rope() = default;
+
+    explicit Rope(std::string_view text) {
+        root = build(text);
+    }
+
+    std::size_t length() const {
+        return lengthOf(root);
+    }
+
+    std::size_t size() const {
+        return length();
+    }
+
+    bool empty() const {
+        return length() == 0;
+    }
+
+    char operator[](std::size_t pos) const {
+        const Node* node = root.get();
+        for (;;) {
+            std::size_t left = lengthOf(node->left);
+            if (pos < left) {
+                node = node->left.get();
+            } else if (pos < left + node->chunk->size()) {
+                return (*node->chunk)[pos - left];
+            } else {
+                pos -= left + node->chunk->size();
+                node = node->right.get();
+            }
+        }
+    }
+
+    char at(std::size_t pos) const {
+        if (pos >= length()) {
+            throw std::out_of_range("Rope::at: position out of range");
+        }
+        return (*this)[pos];
+    }
+
+    std::string substr(std::size_t pos = 0, std::size_t count = npos) const {
+        checkPosition(pos, "Rope::substr");
+        count = std::min(count, length() - pos);
+        std::string result;
+        result.reserve(count);
+        forEachChunk(pos, count, [&](std::string_view chunk) { result.append(chunk); });
+        return result;
+    }
+
+    // Position of the first occurrence of needle at or after pos, or npos
+    std::size_t find(std::string_view needle, std::size_t pos = 0) const {
+        const std::size_t total = length();
+        if (pos > total || needle.size() > total - pos) {
+            return npos;
+        }
+        if (needle.empty()) {
+            return pos;
+        }
+        // Matches can straddle chunks, so the last needle.size() - 1 bytes of what was
+        // searched so far are kept and searched again together with the next chunk
+        std::string window;
+        std::size_t windowStart = pos;
+        std::size_t found = npos;
+        forEachChunk(pos, total - pos, [&](std::string_view chunk) {
+            window.append(chunk);
+            std::size_t hit = window.find(needle);
+            if (hit != std::string::npos) {
+                found = windowStart + hit;
+                return false;
+            }
+            std::size_t keep = std::min(window.size(), needle.size() - 1);
+            windowStart += window.size() - keep;
+            window.erase(0, window.size() - keep);
+            return true;
+        });
+        return found;
+    }
+
+    Rope& insert(std::size_t pos, std::string_view text) {
+        checkPosition(pos, "Rope::insert");
+        if (text.empty()) {
+            return *this;
+        }
+        if (NodePtr edited = insertInChunk(root, pos, text)) {
+            root = std::move(edited);
+            return *this;
+        }
+        auto [left, right] = split(root, pos);
+        root = merge(merge(left, build(text)), right);
+        return *this;
+    }
+
+    Rope& erase(std::size_t pos = 0, std::size_t count = npos) {
+        checkPosition(pos, "Rope::erase");
+        count = std::min(count, length() - pos);
+        if (count == 0) {
+            return *this;
+        }
+        if (NodePtr edited = eraseInChunk(root, pos, count)) {
+            root = std::move(edited);
+            return *this;
+        }
+        auto [left, rest] = split(root, pos);
+        auto [removed, right] = split(rest, count);
+        root = merge(left, right);
+        return *this;
+    }
+
+    Rope& replace(std::size_t pos, std::size_t count, std::string_view text) {
+        checkPosition(pos, "Rope::replace");
+        erase(pos, count);
+        return insert(pos, text);
+    }
+
+    std::string toString() const {
+        return substr();
+    }
+
+    // Calls fn(std::string_view) on the chunks that make up the text, in order. If fn
+    // returns bool, returning false stops the walk there.
+    template <typename Fn>
+    void forEachChunk(Fn fn) const {
+        forEachChunk(0, length(), fn);
+    }
+
+    // Calls fn(std::string_view) on the pieces of the text in [pos, pos + count), in order,
+    // with the same early stop
+    template <typename Fn>
+    void forEachChunk(std::size_t pos, std::size_t count, Fn fn) const {
+        if constexpr (std::is_same_v<decltype(fn(std::string_view())), bool>) {
+            visit(root.get(), pos, count, fn);
+        } else {
+            auto visitAll = [&fn](std::string_view chunk) {
+                fn(chunk);
+                return true;
+            };
+            visit(root.get(), pos, count, visitAll);
+        }
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const Rope& rope) {
+        rope.forEachChunk([&](std::string_view chunk) { out << chunk; });
+        return out;
+    }
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    // Chunks are shared too, so copying a node on an edit path does not copy its text
+    using Chunk = std::shared_ptr<const std::string>;
+
+    struct Node {
+        Chunk chunk;
+        std::size_t length;      // Bytes in this subtree
+        std::uint32_t priority;  // Heap order of the treap: never below a child's
+        NodePtr left;
+        NodePtr right;
+    };
+
+    static std::size_t lengthOf(const NodePtr& node) {
+        return node ? node->length : 0;
+    }
+
+    static std::size_t lengthOf(const Node* node) {
+        return node ? node->length : 0;
+    }
+
+    static NodePtr makeNode(Chunk chunk, std::uint32_t priority, NodePtr left, NodePtr right) {
+        const std::size_t length = lengthOf(left) + chunk->size() + lengthOf(right);
+        return std::make_shared<const Node>(Node{std::move(chunk), length, priority, std::move(left), std::move(right)});
+    }
+
+    static NodePtr makeNode(std::string text, std::uint32_t priority, NodePtr left, NodePtr right) {
+        return makeNode(std::make_shared<const std::string>(std::move(text)), priority, std::move(left), std::move(right));
+    }
+
+    std::uint32_t nextPriority() {
+        // xorshift32; random priorities keep the expected depth logarithmic
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    void checkPosition(std::size_t pos, const char* what) const {
+        if (pos > length()) {
+            throw std::out_of_range(std::string(what) + ": position out of range");
+        }
+    }
+
+    // Balanced tree over text cut into kBuildChunk pieces. Each node takes the highest of its
+    // own random priority and its children's, which keeps the heap order and gives the root
+    // the priority a treap of that many nodes would have, so merging the tree into a larger
+    // one neither buries it nor puts it on top every time.
+    NodePtr build(std::string_view text) {
+        const std::size_t chunks = (text.size() + kBuildChunk - 1) / kBuildChunk;
+        return build(text, 0, chunks);
+    }
+
+    NodePtr build(std::string_view text, std::size_t first, std::size_t last) {
+        if (first == last) {
+            return nullptr;
+        }
+        const std::size_t middle = first + (last - first) / 2;
+        NodePtr left = build(text, first, middle);
+        NodePtr right = build(text, middle + 1, last);
+        std::uint32_t priority = nextPriority();
+        priority = std::max({priority, left ? left->priority : 0u, right ? right->priority : 0u});
+        std::string chunk(text.substr(middle * kBuildChunk, kBuildChunk));
+        return makeNode(std::move(chunk), priority, std::move(left), std::move(right));
+    }
+
+    // Splits into the first pos bytes and the rest; a chunk that straddles pos is cut in two
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& node, std::size_t pos) {
+        if (!node) {
+            return {nullptr, nullptr};
+        }
+        const std::size_t left = lengthOf(node->left);
+        if (pos <= left) {
+            auto [a, b] = split(node->left, pos);
+            return {a, makeNode(node->chunk, node->priority, b, node->right)};
+        }
+        if (pos >= left + node->chunk->size()) {
+            auto [a, b] = split(node->right, pos - left - node->chunk->size());
+            return {makeNode(node->chunk, node->priority, node->left, a), b};
+        }
+        const std::size_t cut = pos - left;
+        return {makeNode(node->chunk->substr(0, cut), node->priority, node->left, nullptr),
+                makeNode(node->chunk->substr(cut), node->priority, nullptr, node->right)};
+    }
+
+    // Concatenation of two trees; the root with the higher priority stays on top
+    static NodePtr merge(const NodePtr& a, const NodePtr& b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (a->priority >= b->priority) {
+            return makeNode(a->chunk, a->priority, a->left, merge(a->right, b));
+        }
+        return makeNode(b->chunk, b->priority, merge(a, b->left), b->right);
+    }
+
+    // The edit rewritten into the one chunk it falls in, or nullptr if that chunk would grow
+    // past kMaxChunk. An insert at a chunk boundary goes to the end of the chunk on the left.
+    static NodePtr insertInChunk(const NodePtr& node, std::size_t pos, std::string_view text) {
+        if (!node) {
+            return nullptr;
+        }
+        const std::size_t left = lengthOf(node->left);
+        if (pos <= left && node->left) {
+            NodePtr edited = insertInChunk(node->left, pos, text);
+            return edited ? makeNode(node->chunk, node->priority, std::move(edited), node->right) : nullptr;
+        }
+        if (pos <= left + node->chunk->size()) {
+            if (node->chunk->size() + text.size() > kMaxChunk) {
+                return nullptr;
+            }
+            std::string chunk = *node->chunk;
+            chunk.insert(pos - left, text);
+            return makeNode(std::move(chunk), node->priority, node->left, node->right);
+        }
+        NodePtr edited = insertInChunk(node->right, pos - left - node->chunk->size(), text);
+        return edited ? makeNode(node->chunk, node->priority, node->left, std::move(edited)) : nullptr;
+    }
+
+    // The erase rewritten into one chunk, or nullptr if it spans chunks or empties one
+    static NodePtr eraseInChunk(const NodePtr& node, std::size_t pos, std::size_t count) {
+        if (!node) {
+            return nullptr;
+        }
+        const std::size_t left = lengthOf(node->left);
+        if (pos < left) {
+            NodePtr edited = eraseInChunk(node->left, pos, count);
+            return edited ? makeNode(node->chunk, node->priority, std::move(edited), node->right) : nullptr;
+        }
+        if (pos < left + node->chunk->size()) {
+            const std::size_t offset = pos - left;
+            if (offset + count > node->chunk->size() || count == node->chunk->size()) {
+                return nullptr;
+            }
+            std::string chunk = *node->chunk;
+            chunk.erase(offset, count);
+            return makeNode(std::move(chunk), node->priority, node->left, node->right);
+        }
+        NodePtr edited = eraseInChunk(node->right, pos - left - node->chunk->size(), count);
+        return edited ? makeNode(node->chunk, node->priority, node->left, std::move(edited)) : nullptr;
+    }
+
+    // Calls fn on the pieces of [pos, pos + count) under node; false if fn returned false,
+    // which ends the walk without visiting the rest
+    template <typename Fn>
+    static bool visit(const Node* node, std::size_t pos, std::size_t count, Fn& fn) {
+        if (!node || count == 0) {
+            return true;
+        }
+        const std::size_t left = lengthOf(node->left);
+        if (pos < left) {
+            const std::size_t take = std::min(count, left - pos);
+            if (!visit(node->left.get(), pos, take, fn)) {
+                return false;
+            }
+            pos = left;
+            count -= take;
+        }
+        if (count == 0) {
+            return true;
+        }
+        const std::size_t end = left + node->chunk->size();
+        if (pos < end) {
+            const std::size_t take = std::min(count, end - pos);
+            if (!fn(std::string_view(*node->chunk).substr(pos - left, take))) {
+                return false;
+            }
+            pos = end;
+            count -= take;
+        }
+        return count == 0 || visit(node->right.get(), pos - end, count, fn);
+    }
+
+    NodePtr root;
+    std::uint32_t seed = 2463534242u;
+};
@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Rope.h"
+
+// Replays the same random sequence of small insert/erase/replace edits on a large text held
+// in a std::string and in a Rope, taking a snapshot every 1000 edits (a full copy for
+// std::string, a shared root for Rope). Afterwards the final texts, every snapshot and a few
+// find() results must agree; any difference is reported and makes the program exit with
+// status 1.
+//
+// Usage: Rope_Benchmark [textMB] [edits]
+//        (defaults: 8 and 20000; std::string needs time proportional to textMB * edits)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+namespace {
+
+struct Edit {
+    enum Kind { Insert, Erase, Replace } kind;
+    double position; // Fraction of the current length, so both texts edit the same place
+    std::size_t count;
+    std::string text;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t textMB = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+    std::size_t editCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    const std::size_t snapshotEvery = 1000;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string initial(textMB << 20, ' ');
+    for (char& c : initial) {
+        c = static_cast<char>(letter(gen));
+    }
+
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_real_distribution<double> where(0.0, 1.0);
+    std::uniform_int_distribution<std::size_t> size(1, 16);
+    std::vector<Edit> edits(editCount);
+    for (Edit& edit : edits) {
+        int k = kind(gen);
+        edit.kind = k < 4 ? Edit::Insert : k < 8 ? Edit::Erase : Edit::Replace;
+        edit.position = where(gen);
+        edit.count = size(gen);
+        edit.text.resize(size(gen));
+        for (char& c : edit.text) {
+            c = static_cast<char>(letter(gen));
+        }
+    }
+
+    auto replay = [&](auto& text, auto& snapshots) {
+        for (std::size_t i = 0; i < edits.size(); ++i) {
+            const Edit& edit = edits[i];
+            const std::size_t pos = static_cast<std::size_t>(edit.position * static_cast<double>(text.length()));
+            switch (edit.kind) {
+            case Edit::Insert:
+                text.insert(pos, edit.text);
+                break;
+            case Edit::Erase:
+                text.erase(pos, edit.count);
+                break;
+            case Edit::Replace:
+                text.replace(pos, edit.count, edit.text);
+                break;
+            }
+            if ((i + 1) % snapshotEvery == 0) {
+                snapshots.push_back(text);
+            }
+        }
+    };
+
+    std::string str;
+    std::vector<std::string> stringSnapshots;
+    double stringTime = measureSeconds(1, [&] {
+        str = initial;
+        replay(str, stringSnapshots);
+    });
+
+    Rope rope;
+    std::vector<Rope> ropeSnapshots;
+    double ropeBuild = measureSeconds(1, [&] { rope = Rope(initial); });
+    double ropeTime = measureSeconds(1, [&] { replay(rope, ropeSnapshots); });
+
+    bool ok = rope.toString() == str && ropeSnapshots.size() == stringSnapshots.size();
+    for (std::size_t i = 0; ok && i < ropeSnapshots.size(); ++i) {
+        ok = ropeSnapshots[i].toString() == stringSnapshots[i];
+    }
+    for (const Edit& edit : edits) {
+        if (!ok || &edit - edits.data() >= 100) {
+            break;
+        }
+        const std::size_t from = static_cast<std::size_t>(edit.position * static_cast<double>(str.length()));
+        ok = rope.find(edit.text, from) == str.find(edit.text, from)
+             && rope.substr(from, 64) == str.substr(from, 64);
+    }
+
+    std::cout << "Text: " << textMB << " MB, " << edits.size() << " edits, a snapshot every " << snapshotEvery
+              << std::endl;
+    std::cout << "std::string: " << stringTime * 1e3 << " ms ("
+              << stringTime / static_cast<double>(edits.size()) * 1e6 << " us per edit)" << std::endl;
+    std::cout << "Rope:        " << ropeTime * 1e3 << " ms ("
+              << ropeTime / static_cast<double>(edits.size()) * 1e6 << " us per edit), plus "
+              << ropeBuild * 1e3 << " ms to build" << std::endl;
+    std::cout << (ok ? "Rope matches std::string." : "Rope differs from std::string!") << std::endl;
+    return ok ? 0 : 1;
+}
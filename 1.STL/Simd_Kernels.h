@@ -0,0 +1,384 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Explicit SSE2/AVX2 kernels for the hot int loops of Algorithms.cpp and Lambda.cpp
+//
+//     simdAdd(vec.data(), vec.size(), 1);                        // for_each with n++
+//     simdMultiply(vec.data(), vec.size(), 2);                   // for_each with n *= 2
+//     std::size_t i = simdFindFirstGreater(vec.data(), vec.size(), 5);   // find_if(n > 5)
+// The find functions return the index of the first match, or n if there is none.
+//
+// Compilers often leave these loops scalar when the operation sits in a lambda, and a
+// find_if never gets vectorized because of its early exit. The kernels here process 4 (SSE2)
+// or 8 (AVX2) ints per instruction; the searches compare a whole vector at once and use
+// movemask to get a bit per lane, so the first set bit is the first match.
+//
+// The widest kernel set the CPU supports is picked once, on first use (see simdLevel()).
+// SSE2 is part of every x86-64 CPU; AVX2 is compiled with a target attribute, so the file
+// builds without -mavx2 and still runs on older machines. Other architectures get the
+// scalar loops. Arithmetic wraps around on overflow in every kernel.
+
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+// Index of the lowest set bit of a movemask result or a 64-bit block mask; mask must not be 0
+inline unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned lowestSetBit(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // _BitScanForward64 only exists in 64-bit builds, so scan the halves
+    unsigned long index;
+    if (static_cast<std::uint32_t>(mask) != 0) {
+        _BitScanForward(&index, static_cast<unsigned long>(mask));
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+// One implementation of every kernel
+struct IntKernels {
+    void (*add)(int* data, std::size_t n, int value);
+    void (*multiply)(int* data, std::size_t n, int factor);
+    std::size_t (*findFirstGreater)(const int* data, std::size_t n, int limit);
+    std::size_t (*findFirstLess)(const int* data, std::size_t n, int limit);
+    std::size_t (*findFirstEqual)(const int* data, std::size_t n, int value);
+};
+
+// Scalar kernels: the fallback, and the tail loop of the vector kernels.
+// The arithmetic is done on unsigned values so that overflow wraps instead of being undefined.
+inline void scalarAdd(int* data, std::size_t n, int value) {
+    for (std::size_t i = 0; i < n; ++i) {
+        data[i] = static_cast<int>(static_cast<std::uint32_t>(data[i]) + static_cast<std::uint32_t>(value));
+    }
+}
+
+inline void scalarMultiply(int* data, std::size_t n, int factor) {
+    for (std::size_t i = 0; i < n; ++i) {
+        data[i] = static_cast<int>(static_cast<std::uint32_t>(data[i]) * static_cast<std::uint32_t>(factor));
+    }
+}
+
+inline std::size_t scalarFindFirstGreater(const int* data, std::size_t n, int limit) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (data[i] > limit) {
+            return i;
+        }
+    }
+    return n;
+}
+
+inline std::size_t scalarFindFirstLess(const int* data, std::size_t n, int limit) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (data[i] < limit) {
+            return i;
+        }
+    }
+    return n;
+}
+
+inline std::size_t scalarFindFirstEqual(const int* data, std::size_t n, int value) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+// SSE2 kernels, 4 ints per step
+
+inline void sse2Add(int* data, std::size_t n, int value) {
+    const __m128i v = _mm_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), v));
+    }
+    scalarAdd(data + i, n - i, value);
+}
+
+// SSE2 has no 32-bit multiply (_mm_mullo_epi32 is SSE4.1), so the even and odd lanes are
+// multiplied separately with _mm_mul_epu32 and the low halves of the products put back together
+inline void sse2Multiply(int* data, std::size_t n, int factor) {
+    const __m128i f = _mm_set1_epi32(factor);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        __m128i x = _mm_loadu_si128(p);
+        __m128i even = _mm_mul_epu32(x, f);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), f);
+        __m128i low = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                         _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        _mm_storeu_si128(p, low);
+    }
+    scalarMultiply(data + i, n - i, factor);
+}
+
+// Kind of comparison done by the vector searches
+enum class SimdCompare { Greater, Less, Equal };
+
+template <SimdCompare kind>
+inline bool scalarCompare(int x, int value) {
+    return kind == SimdCompare::Greater ? x > value : kind == SimdCompare::Less ? x < value : x == value;
+}
+
+// All ones in the lanes of x that match
+template <SimdCompare kind>
+inline __m128i sse2Compare(__m128i x, __m128i v) {
+    if (kind == SimdCompare::Greater) {
+        return _mm_cmpgt_epi32(x, v);
+    } else if (kind == SimdCompare::Less) {
+        return _mm_cmplt_epi32(x, v);
+    } else {
+        return _mm_cmpeq_epi32(x, v);
+    }
+}
+
+template <SimdCompare kind>
+std::size_t sse2FindFirst(const int* data, std::size_t n, int value) {
+    const __m128i v = _mm_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = sse2Compare<kind>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), v);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(x)));
+        if (mask != 0) {
+            return i + lowestSetBit(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (scalarCompare<kind>(data[i], value)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+inline std::size_t sse2FindFirstGreater(const int* data, std::size_t n, int limit) {
+    return sse2FindFirst<SimdCompare::Greater>(data, n, limit);
+}
+
+inline std::size_t sse2FindFirstLess(const int* data, std::size_t n, int limit) {
+    return sse2FindFirst<SimdCompare::Less>(data, n, limit);
+}
+
+inline std::size_t sse2FindFirstEqual(const int* data, std::size_t n, int value) {
+    return sse2FindFirst<SimdCompare::Equal>(data, n, value);
+}
+
+// AVX2 kernels, 8 ints per step. The searches check two vectors per iteration, so the
+// loop branch is taken once every 16 ints.
+
+SIMD_TARGET_AVX2 inline void avx2Add(int* data, std::size_t n, int value) {
+    const __m256i v = _mm256_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), v));
+    }
+    scalarAdd(data + i, n - i, value);
+}
+
+SIMD_TARGET_AVX2 inline void avx2Multiply(int* data, std::size_t n, int factor) {
+    const __m256i f = _mm256_set1_epi32(factor);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_mullo_epi32(_mm256_loadu_si256(p), f));
+    }
+    scalarMultiply(data + i, n - i, factor);
+}
+
+template <SimdCompare kind>
+SIMD_TARGET_AVX2 inline __m256i avx2Compare(__m256i x, __m256i v) {
+    if (kind == SimdCompare::Greater) {
+        return _mm256_cmpgt_epi32(x, v);
+    } else if (kind == SimdCompare::Less) {
+        return _mm256_cmpgt_epi32(v, x);
+    } else {
+        return _mm256_cmpeq_epi32(x, v);
+    }
+}
+
+template <SimdCompare kind>
+SIMD_TARGET_AVX2 inline std::size_t avx2FindFirst(const int* data, std::size_t n, int value) {
+    const __m256i v = _mm256_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = avx2Compare<kind>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v);
+        __m256i b = avx2Compare<kind>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8)), v);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(a, b))));
+        if (mask != 0) {
+            unsigned low = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(a)));
+            unsigned high = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(b)));
+            return low != 0 ? i + lowestSetBit(low) : i + 8 + lowestSetBit(high);
+        }
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = avx2Compare<kind>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(a)));
+        if (mask != 0) {
+            return i + lowestSetBit(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (scalarCompare<kind>(data[i], value)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2FindFirstGreater(const int* data, std::size_t n, int limit) {
+    return avx2FindFirst<SimdCompare::Greater>(data, n, limit);
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2FindFirstLess(const int* data, std::size_t n, int limit) {
+    return avx2FindFirst<SimdCompare::Less>(data, n, limit);
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2FindFirstEqual(const int* data, std::size_t n, int value) {
+    return avx2FindFirst<SimdCompare::Equal>(data, n, value);
+}
+
+// Whether the CPU and the operating system support AVX2 (the OS has to save the YMM registers)
+inline bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Widest instruction set this machine can run the kernels with
+inline SimdLevel detectSimdLevel() {
+#ifdef SIMD_KERNELS_X86
+    return cpuHasAvx2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// The kernel table of a level, for intKernels(SimdLevel) below and the xxxKernels(SimdLevel)
+// of the headers built on this one; the benchmarks call those directly to compare the levels,
+// everything else goes through simdLevel(). The SSE2 and AVX2 tables only exist on x86, so
+// other builds use the one-table overload and get the scalar kernels at every level.
+template <typename Kernels>
+const Kernels& kernelsForLevel(SimdLevel level, const Kernels& scalar, const Kernels& sse2, const Kernels& avx2) {
+    switch (level) {
+    case SimdLevel::AVX2:
+        return avx2;
+    case SimdLevel::SSE2:
+        return sse2;
+    default:
+        return scalar;
+    }
+}
+
+template <typename Kernels>
+const Kernels& kernelsForLevel(SimdLevel, const Kernels& scalar) {
+    return scalar;
+}
+
+inline const IntKernels& intKernels(SimdLevel level) {
+    static const IntKernels scalar = {scalarAdd, scalarMultiply, scalarFindFirstGreater, scalarFindFirstLess,
+                                      scalarFindFirstEqual};
+#ifdef SIMD_KERNELS_X86
+    static const IntKernels sse2 = {sse2Add, sse2Multiply, sse2FindFirstGreater, sse2FindFirstLess,
+                                    sse2FindFirstEqual};
+    static const IntKernels avx2 = {avx2Add, avx2Multiply, avx2FindFirstGreater, avx2FindFirstLess,
+                                    avx2FindFirstEqual};
+    return kernelsForLevel(level, scalar, sse2, avx2);
+#else
+    return kernelsForLevel(level, scalar);
+#endif
+}
+
+// Level used by the simd* functions, detected once
+inline SimdLevel simdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+inline const IntKernels& intKernels() {
+    static const IntKernels& kernels = intKernels(simdLevel());
+    return kernels;
+}
+
+// Adds value to every element
+inline void simdAdd(int* data, std::size_t n, int value) {
+    intKernels().add(data, n, value);
+}
+
+// Multiplies every element by factor
+inline void simdMultiply(int* data, std::size_t n, int factor) {
+    intKernels().multiply(data, n, factor);
+}
+
+// Index of the first element greater than limit, or n
+inline std::size_t simdFindFirstGreater(const int* data, std::size_t n, int limit) {
+    return intKernels().findFirstGreater(data, n, limit);
+}
+
+// Index of the first element less than limit, or n
+inline std::size_t simdFindFirstLess(const int* data, std::size_t n, int limit) {
+    return intKernels().findFirstLess(data, n, limit);
+}
+
+// Index of the first element equal to value, or n
+inline std::size_t simdFindFirstEqual(const int* data, std::size_t n, int value) {
+    return intKernels().findFirstEqual(data, n, value);
+}
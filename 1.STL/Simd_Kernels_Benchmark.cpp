@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Simd_Kernels.h"
+
+// Compares the kernels of Simd_Kernels.h at every level this CPU supports with the
+// std::for_each / std::find_if loops of Algorithms.cpp and Lambda.cpp:
+// n++, n *= 2, find_if(n > limit), find_if(n < limit) and find_if(n == value).
+// Each search has a single match at 3/4 of the vector.
+// Every kernel result is compared with the std one; any difference is reported and makes
+// the program exit with status 1.
+//
+// Usage: Simd_Kernels_Benchmark [elements]   (default: 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3 (no -mavx2 needed; -march=native lets
+// the compiler vectorize the std loops too, which makes for a fairer comparison)
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int repeats = 5;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, 999999);
+    std::vector<int> data(elements);
+    for (int& value : data) {
+        value = dis(gen);
+    }
+    // Each search has exactly one match, at about 3/4 of the way in
+    const std::size_t matchAt = elements * 3 / 4;
+    if (matchAt + 1 < elements) {
+        data[matchAt] = -1;          // The only value below 0 and the only -1
+        data[matchAt + 1] = 1000000; // The only value above 999999
+    }
+
+    // Reference results
+    std::vector<int> added = data;
+    std::for_each(added.begin(), added.end(), [](int& n) { n++; });
+    std::vector<int> multiplied = data;
+    std::for_each(multiplied.begin(), multiplied.end(), [](int& n) { n *= 2; });
+
+    std::vector<int> work = data;
+    std::size_t found = 0;
+    const double perElement = 1e9 / static_cast<double>(std::max<std::size_t>(1, elements));
+    double stdAdd = measureSeconds(repeats, [&] {
+        std::for_each(work.begin(), work.end(), [](int& n) { n++; });
+        doNotOptimize(work.data());
+    });
+    double stdMultiply = measureSeconds(repeats, [&] {
+        std::for_each(work.begin(), work.end(), [](int& n) { n *= 2; });
+        doNotOptimize(work.data());
+    });
+    double stdGreater = measureSeconds(repeats, [&] {
+        found = static_cast<std::size_t>(std::find_if(data.begin(), data.end(), [](int n) { return n > 999999; }) -
+                                         data.begin());
+        doNotOptimize(found);
+    });
+    double stdLess = measureSeconds(repeats, [&] {
+        found = static_cast<std::size_t>(std::find_if(data.begin(), data.end(), [](int n) { return n < 0; }) -
+                                         data.begin());
+        doNotOptimize(found);
+    });
+    double stdEqual = measureSeconds(repeats, [&] {
+        found = static_cast<std::size_t>(std::find(data.begin(), data.end(), -1) - data.begin());
+        doNotOptimize(found);
+    });
+    const std::size_t expectedGreater =
+        static_cast<std::size_t>(std::find_if(data.begin(), data.end(), [](int n) { return n > 999999; }) -
+                                 data.begin());
+    const std::size_t expectedLess =
+        static_cast<std::size_t>(std::find_if(data.begin(), data.end(), [](int n) { return n < 0; }) - data.begin());
+    const std::size_t expectedEqual = static_cast<std::size_t>(std::find(data.begin(), data.end(), -1) - data.begin());
+
+    std::cout << "Elements: " << elements << ", detected level: " << simdLevelName(simdLevel()) << std::endl;
+    std::cout << std::left << std::setw(8) << "" << std::right << std::setw(14) << "n++" << std::setw(14)
+              << "n *= 2" << std::setw(14) << "find n > x" << std::setw(14) << "find n < x" << std::setw(14)
+              << "find n == x" << "   (ns per element)" << std::endl;
+    auto printRow = [&](const char* label, double add, double multiply, double greater, double less, double equal) {
+        std::cout << std::left << std::setw(8) << label << std::right << std::fixed << std::setprecision(3);
+        for (double t : {add, multiply, greater, less, equal}) {
+            std::cout << std::setw(14) << t * perElement;
+        }
+        std::cout << std::endl;
+    };
+    printRow("std", stdAdd, stdMultiply, stdGreater, stdLess, stdEqual);
+
+    bool ok = true;
+    auto check = [&](bool same, const char* what, SimdLevel level) {
+        if (!same) {
+            std::cout << "MISMATCH: " << what << " at level " << simdLevelName(level) << std::endl;
+            ok = false;
+        }
+    };
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > simdLevel()) {
+            break;
+        }
+        const IntKernels& kernels = intKernels(level);
+
+        work = data;
+        kernels.add(work.data(), work.size(), 1);
+        check(work == added, "add", level);
+        work = data;
+        kernels.multiply(work.data(), work.size(), 2);
+        check(work == multiplied, "multiply", level);
+        check(kernels.findFirstGreater(data.data(), data.size(), 999999) == expectedGreater, "findFirstGreater",
+              level);
+        check(kernels.findFirstLess(data.data(), data.size(), 0) == expectedLess, "findFirstLess", level);
+        check(kernels.findFirstEqual(data.data(), data.size(), -1) == expectedEqual, "findFirstEqual", level);
+
+        double add = measureSeconds(repeats, [&] {
+            kernels.add(work.data(), work.size(), 1);
+            doNotOptimize(work.data());
+        });
+        double multiply = measureSeconds(repeats, [&] {
+            kernels.multiply(work.data(), work.size(), 2);
+            doNotOptimize(work.data());
+        });
+        double greater = measureSeconds(repeats, [&] {
+            found = kernels.findFirstGreater(data.data(), data.size(), 999999);
+            doNotOptimize(found);
+        });
+        double less = measureSeconds(repeats, [&] {
+            found = kernels.findFirstLess(data.data(), data.size(), 0);
+            doNotOptimize(found);
+        });
+        double equal = measureSeconds(repeats, [&] {
+            found = kernels.findFirstEqual(data.data(), data.size(), -1);
+            doNotOptimize(found);
+        });
+        printRow(simdLevelName(level), add, multiply, greater, less, equal);
+    }
+
+    std::cout << (ok ? "All kernel results match std." : "Kernel results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
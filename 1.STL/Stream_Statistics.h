@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Top-k and quantiles of int streams without sorting everything
+//
+// Algorithms.cpp sorts the whole vector even when only the largest few values or a median
+// are needed. The classes here consume ints one at a time:
+//     TopK top(10);                      // exact: the 10 largest values seen
+//     QuantileSketch sketch;             // approximate quantiles in a few KB
+//     for (int value : stream) {
+//         top.push(value);
+//         sketch.push(value);
+//     }
+//     std::vector<int> largest = top.values();        // descending
+//     int p99 = sketch.quantile(0.99);
+// For data that is already in memory, exactQuantiles() finds exact quantiles with
+// std::nth_element in O(n) instead of sorting in O(n log n).
+//
+// Both classes merge: summaries built by several threads over parts of a stream can be
+// combined into one that describes the whole stream, so the work scales across cores.
+//
+// Quantile q (0 <= q <= 1) of n values is the value at 0-based rank floor(q * (n - 1)) in
+// sorted order; quantile(0) is the minimum and quantile(1) the maximum.
+
+// The k largest values of a stream, kept in a min-heap of size k
+class TopK {
+public:
+    explicit TopK(std::size_t k) : k(k) {
+        heap.reserve(k);
+    }
+
+    void push(int value) {
+        if (heap.size() < k) {
+            heap.push_back(value);
+            std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+        } else if (k > 0 && value > heap.front()) {
+            // Replaces the smallest kept value
+            std::pop_heap(heap.begin(), heap.end(), std::greater<int>());
+            heap.back() = value;
+            std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+        }
+    }
+
+    // Adds the values kept by other (for example a TopK filled by another thread)
+    void merge(const TopK& other) {
+        for (int value : other.heap) {
+            push(value);
+        }
+    }
+
+    std::size_t size() const {
+        return heap.size();
+    }
+
+    // The kept values, largest first
+    std::vector<int> values() const {
+        std::vector<int> sorted = heap;
+        std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+        return sorted;
+    }
+
+private:
+    std::size_t k;
+    std::vector<int> heap; // Min-heap: front() is the smallest of the k largest
+};
+
+// Index of quantile q among n sorted values
+inline std::size_t quantileRank(double q, std::size_t n) {
+    if (!(q >= 0.0 && q <= 1.0)) {
+        throw std::invalid_argument("quantile: q must be between 0 and 1");
+    }
+    return static_cast<std::size_t>(std::floor(q * static_cast<double>(n - 1)));
+}
+
+// Exact quantiles of values, one per entry of qs, in O(n) per quantile at worst.
+// values is reordered. Each std::nth_element call only works on the part of the range
+// between the previous rank and the end, so asking for many quantiles at once costs less
+// than asking for them one by one.
+inline std::vector<int> exactQuantiles(std::vector<int>& values, const std::vector<double>& qs) {
+    if (values.empty()) {
+        throw std::invalid_argument("exactQuantiles: no values");
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> ranks; // (rank, index in qs)
+    for (std::size_t i = 0; i < qs.size(); ++i) {
+        ranks.emplace_back(quantileRank(qs[i], values.size()), i);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    std::vector<int> result(qs.size());
+    auto first = values.begin();
+    for (const auto& [rank, index] : ranks) {
+        auto nth = values.begin() + static_cast<std::ptrdiff_t>(rank);
+        if (nth >= first) {
+            std::nth_element(first, nth, values.end());
+            first = nth;
+        }
+        result[index] = *nth;
+    }
+    return result;
+}
+
+inline int exactQuantile(std::vector<int>& values, double q) {
+    return exactQuantiles(values, {q})[0];
+}
+
+// QuantileSketch: approximate quantiles of an unbounded stream in bounded memory (a KLL sketch)
+//
+// Values are kept in levels; a value at level h stands for 2^h values of the stream. When a
+// level is full it is sorted and every second value (starting at a random one of the first
+// two) moves up a level, which halves its size and doubles the weight of what moves.
+// Higher levels get larger capacities (the top level k, each level below it 2/3 of the one
+// above, but at least 8), so the sketch holds about 3k values plus 8 per level however long
+// the stream is.
+//
+// The rank error is about 1.7 / k of the stream length with high probability (about 1% for
+// the default k = 200). The minimum and maximum are tracked exactly.
+class QuantileSketch {
+public:
+    explicit QuantileSketch(std::size_t k = 200, std::uint64_t seed = 0x9e3779b97f4a7c15ull)
+        : k(std::max<std::size_t>(kMinCapacity, k)), random(seed | 1) {
+        addLevel();
+    }
+
+    void push(int value) {
+        levels[0].push_back(value);
+        ++count;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        if (levels[0].size() >= capacities[0]) {
+            compress();
+        }
+    }
+
+    // Adds everything other has seen (for example a sketch filled by another thread)
+    void merge(const QuantileSketch& other) {
+        while (levels.size() < other.levels.size()) {
+            addLevel();
+        }
+        for (std::size_t h = 0; h < other.levels.size(); ++h) {
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        }
+        count += other.count;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+        compress();
+    }
+
+    // Number of values pushed
+    std::uint64_t size() const {
+        return count;
+    }
+
+    // Values stored in the sketch
+    std::size_t retained() const {
+        std::size_t total = 0;
+        for (const std::vector<int>& level : levels) {
+            total += level.size();
+        }
+        return total;
+    }
+
+    // Approximate quantile q; the sketch must not be empty
+    int quantile(double q) const {
+        return quantiles({q})[0];
+    }
+
+    // Approximate quantiles, one per entry of qs
+    std::vector<int> quantiles(const std::vector<double>& qs) const {
+        if (count == 0) {
+            throw std::invalid_argument("QuantileSketch: no values");
+        }
+        std::vector<std::pair<int, std::uint64_t>> weighted; // (value, weight)
+        for (std::size_t h = 0; h < levels.size(); ++h) {
+            for (int value : levels[h]) {
+                weighted.emplace_back(value, std::uint64_t(1) << h);
+            }
+        }
+        std::sort(weighted.begin(), weighted.end());
+        std::vector<int> result;
+        for (double q : qs) {
+            const std::uint64_t rank = quantileRank(q, static_cast<std::size_t>(count));
+            if (rank == 0) {
+                result.push_back(minimum);
+            } else if (rank == count - 1) {
+                result.push_back(maximum);
+            } else {
+                // First stored value whose cumulative weight passes the rank
+                std::uint64_t seen = 0;
+                int value = maximum;
+                for (const auto& [stored, weight] : weighted) {
+                    seen += weight;
+                    if (seen > rank) {
+                        value = stored;
+                        break;
+                    }
+                }
+                result.push_back(value);
+            }
+        }
+        return result;
+    }
+
+private:
+    // Smallest level capacity; keeps the bottom levels from compacting every few values
+    static constexpr std::size_t kMinCapacity = 8;
+
+    // Adds a level on top and recomputes the capacities, which depend on the distance to the top
+    void addLevel() {
+        levels.emplace_back();
+        capacities.resize(levels.size());
+        double capacity = static_cast<double>(k);
+        for (std::size_t h = levels.size(); h-- > 0;) {
+            capacities[h] = std::max(kMinCapacity, static_cast<std::size_t>(std::ceil(capacity)));
+            capacity *= 2.0 / 3.0;
+        }
+    }
+
+    // Compacts full levels from the bottom up until every level fits
+    void compress() {
+        for (std::size_t h = 0; h < levels.size(); ++h) {
+            if (levels[h].size() < capacities[h]) {
+                continue;
+            }
+            if (h + 1 == levels.size()) {
+                addLevel();
+            }
+            std::vector<int>& level = levels[h];
+            std::sort(level.begin(), level.end());
+            // An odd value out stays behind, so the total weight is unchanged
+            const std::size_t keep = level.size() % 2;
+            const std::size_t offset = keep + (nextRandom() & 1);
+            std::vector<int>& up = levels[h + 1];
+            for (std::size_t i = offset; i < level.size(); i += 2) {
+                up.push_back(level[i]);
+            }
+            level.resize(keep);
+        }
+    }
+
+    std::uint64_t nextRandom() {
+        // xorshift64: cheap, and only used to pick even or odd positions
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        return random;
+    }
+
+    std::size_t k;
+    std::uint64_t random;
+    std::vector<std::vector<int>> levels;
+    std::vector<std::size_t> capacities; // Per level
+    std::uint64_t count = 0;
+    int minimum = std::numeric_limits<int>::max();
+    int maximum = std::numeric_limits<int>::min();
+};
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Stream_Statistics.h"
+#include "Thread_Pool.h"
+
+// Compares ways to get the 100 largest values and the 1%, 25%, 50%, 75%, 99% and 99.9%
+// quantiles of a large vector of random ints:
+//   - std::sort of a copy, then reading the answers off the sorted vector (as Algorithms.cpp does)
+//   - TopK over the stream, and exactQuantiles (std::nth_element) on a copy
+//   - QuantileSketch over the stream, on one thread and as per-thread sketches merged at the end
+// TopK and exactQuantiles must match the sorted vector exactly; the sketch is reported
+// with its worst rank error as a fraction of the stream. Exits with status 1 if an exact
+// result differs or the sketch error exceeds 3%.
+//
+// Usage: Stream_Statistics_Benchmark [elements] [threads]
+//        (defaults: 50000000 and std::thread::hardware_concurrency())
+// Build with optimizations and threads, e.g. g++ -std=c++17 -O3 -pthread
+
+int main(int argc, char** argv) {
+    std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : ThreadPool::defaultThreadCount();
+    const std::size_t k = 100;
+    const std::vector<double> qs = {0.01, 0.25, 0.5, 0.75, 0.99, 0.999};
+
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dis(0.0, 1e6);
+    std::vector<int> data(std::max<std::size_t>(1, elements));
+    for (int& value : data) {
+        value = static_cast<int>(dis(gen));
+    }
+
+    // Full sort: the reference
+    std::vector<int> sorted;
+    double sortTime = measureSeconds(1, [&] {
+        sorted = data;
+        std::sort(sorted.begin(), sorted.end());
+    });
+    std::vector<int> expectedTop(sorted.rbegin(), sorted.rbegin() + static_cast<std::ptrdiff_t>(std::min(k, sorted.size())));
+    std::vector<int> expectedQuantiles;
+    for (double q : qs) {
+        expectedQuantiles.push_back(sorted[quantileRank(q, sorted.size())]);
+    }
+
+    std::vector<int> top;
+    double topTime = measureSeconds(1, [&] {
+        TopK topK(k);
+        for (int value : data) {
+            topK.push(value);
+        }
+        top = topK.values();
+    });
+
+    std::vector<int> exact;
+    double nthTime = measureSeconds(1, [&] {
+        std::vector<int> copy = data;
+        exact = exactQuantiles(copy, qs);
+    });
+
+    std::vector<int> approximate;
+    std::size_t retained = 0;
+    double sketchTime = measureSeconds(1, [&] {
+        QuantileSketch sketch;
+        for (int value : data) {
+            sketch.push(value);
+        }
+        approximate = sketch.quantiles(qs);
+        retained = sketch.retained();
+    });
+
+    ThreadPool pool(threads);
+    std::vector<int> merged;
+    double parallelTime = measureSeconds(1, [&] {
+        const std::size_t chunks = pool.size();
+        std::vector<QuantileSketch> sketches;
+        for (std::size_t i = 0; i < chunks; ++i) {
+            sketches.emplace_back(200, 1000 + i);
+        }
+        pool.run(chunks, [&](std::size_t i) {
+            const std::size_t begin = data.size() * i / chunks;
+            const std::size_t end = data.size() * (i + 1) / chunks;
+            for (std::size_t j = begin; j < end; ++j) {
+                sketches[i].push(data[j]);
+            }
+        });
+        for (std::size_t i = 1; i < chunks; ++i) {
+            sketches[0].merge(sketches[i]);
+        }
+        merged = sketches[0].quantiles(qs);
+    });
+
+    // Rank error of an approximate answer: distance between its true rank and the wanted one
+    auto rankError = [&](const std::vector<int>& answers) {
+        double worst = 0.0;
+        for (std::size_t i = 0; i < qs.size(); ++i) {
+            const double wanted = static_cast<double>(quantileRank(qs[i], sorted.size()));
+            const double low = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), answers[i]) - sorted.begin());
+            const double high = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), answers[i]) - sorted.begin()) - 1;
+            const double error = wanted < low ? low - wanted : wanted > high ? wanted - high : 0.0;
+            worst = std::max(worst, error / static_cast<double>(sorted.size()));
+        }
+        return worst;
+    };
+    const double sketchError = rankError(approximate);
+    const double mergedError = rankError(merged);
+
+    std::cout << "Elements: " << data.size() << ", top " << k << ", " << qs.size() << " quantiles, "
+              << pool.size() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "std::sort, then read off:      " << std::setw(9) << sortTime * 1e3 << " ms" << std::endl;
+    std::cout << "TopK:                          " << std::setw(9) << topTime * 1e3 << " ms" << std::endl;
+    std::cout << "exactQuantiles (nth_element):  " << std::setw(9) << nthTime * 1e3 << " ms" << std::endl;
+    std::cout << "QuantileSketch:                " << std::setw(9) << sketchTime * 1e3 << " ms, "
+              << std::setprecision(3) << sketchError * 100 << "% worst rank error, " << retained
+              << " values kept" << std::setprecision(1) << std::endl;
+    std::cout << "QuantileSketch, merged:        " << std::setw(9) << parallelTime * 1e3 << " ms, "
+              << std::setprecision(3) << mergedError * 100 << "% worst rank error" << std::endl;
+
+    bool ok = top == expectedTop && exact == expectedQuantiles && sketchError < 0.03 && mergedError < 0.03;
+    std::cout << (ok ? "TopK and exactQuantiles match std::sort; sketch errors are within bounds."
+                     : "Results differ from std::sort!")
+              << std::endl;
+    return ok ? 0 : 1;
+}
@@ -1,11 +1,16 @@
 #include <iostream>
 #include <string>
 
+#include "Rope.h"
+#include "String_Concat.h"
+#include "String_Search.h"
+#include "Utf8_View.h"
+
 int main() {
     // Creating strings
     std::string str1 = "Hello";
     std::string str2 = "World";
-    std::string str3 = str1 + " " + str2; // Concatenation
+    std::string str3 = concat(str1, " ", str2); // Concatenation in one allocation (see String_Concat.h)
 
     // Output the strings
     std::cout << "str1: " << str1 << std::endl;
@@ -42,5 +47,26 @@ int main() {
     str3.insert(5, " Beautiful");
     std::cout << "After insert: " << str3 << std::endl;
 
+    // The same edits on a Rope: each costs O(log n) however long the text is,
+    // and copies are snapshots that share the text (see Rope.h)
+    Rope text(concat(str1, " ", str2));
+    Rope original = text;
+    text.replace(6, 5, "C++").erase(5, 3).insert(5, " Beautiful");
+    std::cout << "Rope after edits: " << text << " (snapshot: " << original << ")" << std::endl;
+
+    // Vectorized search, and several patterns in one pass (see String_Search.h)
+    std::string greeting = concat(str1, " ", str2);
+    std::cout << "'World' found by simdFind at position: " << simdFind(greeting, "World") << std::endl;
+    MultiPatternSearcher searcher({"Hello", "World", "lo"});
+    searcher.scan(greeting, [](const PatternMatch& match) {
+        std::cout << "Pattern " << match.pattern << " found at position: " << match.position << std::endl;
+    });
+
+    // length() and substr() count bytes; Utf8View counts characters (see Utf8_View.h)
+    std::string german = "Gr\u00fc\u00dfe aus K\u00f6ln";
+    Utf8View characters(german);
+    std::cout << "Bytes: " << german.length() << ", characters: " << characters.length()
+              << ", first five characters: " << std::string_view(characters.substr(0, 5)) << std::endl;
+
     return 0;
 }
\ No newline at end of file
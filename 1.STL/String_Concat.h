@@ -0,0 +1,120 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Concatenation that measures first and allocates once
+//
+// str1 + " " + str2 + std::to_string(age) builds a new std::string for every +, and
+// std::to_string another one for the number. concat() takes all the parts at once, adds up
+// their lengths, allocates the result a single time and copies each part into place:
+//     std::string details = concat(name, ", Age: ", age);       // one allocation at most
+//     appendConcat(line, name, ", Age: ", age);                 // none if line has the capacity
+//     char buffer[64];
+//     std::string_view view = concatInto(buffer, sizeof(buffer), name, ", Age: ", age);  // none
+// Parts can be anything that converts to std::string_view (std::string, string literals),
+// a char, or an integer. Integers are formatted with std::to_chars into a small buffer
+// inside the part, so no std::to_string temporary is made.
+
+// One part of a concatenation: a view of the caller's characters, or a formatted integer
+class ConcatPiece {
+public:
+    ConcatPiece(std::string_view text) : text(text.data()), length(text.size()) {}
+
+    ConcatPiece(const std::string& text) : text(text.data()), length(text.size()) {}
+
+    ConcatPiece(const char* text) : ConcatPiece(std::string_view(text)) {}
+
+    ConcatPiece(char c) : text(nullptr), length(1) {
+        digits[0] = c;
+    }
+
+    template <typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer> &&
+                                                            !std::is_same_v<Integer, char> &&
+                                                            !std::is_same_v<Integer, bool>>>
+    ConcatPiece(Integer value) : text(nullptr) {
+        length = static_cast<std::size_t>(std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+    }
+
+    std::string_view view() const {
+        // Formatted characters live in this object, so their address is taken on demand
+        return text ? std::string_view(text, length) : std::string_view(digits, length);
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+private:
+    const char* text;
+    std::size_t length;
+    char digits[20]; // Fits every 64-bit integer, sign included
+};
+
+// Total length of the pieces
+inline std::size_t concatLength(std::initializer_list<ConcatPiece> pieces) {
+    std::size_t total = 0;
+    for (const ConcatPiece& piece : pieces) {
+        total += piece.size();
+    }
+    return total;
+}
+
+// Copies the pieces to out, which must have room for concatLength(pieces) characters;
+// returns the end of what was written. Nothing is null-terminated.
+inline char* concatTo(char* out, std::initializer_list<ConcatPiece> pieces) {
+    for (const ConcatPiece& piece : pieces) {
+        std::string_view view = piece.view();
+        std::memcpy(out, view.data(), view.size());
+        out += view.size();
+    }
+    return out;
+}
+
+inline std::string concatPieces(std::initializer_list<ConcatPiece> pieces) {
+    std::string result(concatLength(pieces), '\0');
+    concatTo(result.data(), pieces);
+    return result;
+}
+
+inline void appendConcatPieces(std::string& out, std::initializer_list<ConcatPiece> pieces) {
+    const std::size_t start = out.size();
+    out.resize(start + concatLength(pieces));
+    concatTo(out.data() + start, pieces);
+}
+
+inline std::string_view concatIntoPieces(char* buffer, std::size_t capacity, std::initializer_list<ConcatPiece> pieces) {
+    const std::size_t length = concatLength(pieces);
+    if (length > capacity) {
+        throw std::length_error("concatInto: buffer too small");
+    }
+    concatTo(buffer, pieces);
+    return std::string_view(buffer, length);
+}
+
+// The parts joined into a new string with a single allocation (none if the result fits in
+// the string's small buffer)
+template <typename... Parts>
+std::string concat(const Parts&... parts) {
+    return concatPieces({ConcatPiece(parts)...});
+}
+
+// Appends the parts to out; allocates only if out has to grow, so a string that is cleared
+// and reused keeps its capacity and stops allocating
+template <typename... Parts>
+void appendConcat(std::string& out, const Parts&... parts) {
+    appendConcatPieces(out, {ConcatPiece(parts)...});
+}
+
+// Writes the parts to buffer and returns a view of them; throws std::length_error if they
+// need more than capacity characters. Never allocates.
+template <typename... Parts>
+std::string_view concatInto(char* buffer, std::size_t capacity, const Parts&... parts) {
+    return concatIntoPieces(buffer, capacity, {ConcatPiece(parts)...});
+}
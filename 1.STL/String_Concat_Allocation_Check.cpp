@@ -0,0 +1,101 @@
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "String_Concat.h"
+
+// Allocation-count checks for String_Concat.h
+//
+// Global operator new is replaced with a counting version. Each check builds a string the
+// way String.cpp and UserProfile::getUserDetails() do, and fails if the number of allocations
+// differs from the expected one or the text differs from what operator+ produces. The names
+// are longer than the small-string buffer of std::string, so every temporary allocates.
+//
+// Usage: String_Concat_Allocation_Check   (exit code 0 if every check passes)
+
+static std::size_t allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static int failures = 0;
+
+// Runs build() and reports how many allocations it made; atLeast accepts any count from
+// expected up (for the operator+ controls, whose exact count depends on the library)
+template <typename Build>
+void check(const char* name, const std::string& expectedText, std::size_t expected, Build build,
+           bool atLeast = false) {
+    std::size_t before = allocationCount;
+    auto text = build();
+    std::size_t allocations = allocationCount - before;
+    bool passed = (atLeast ? allocations >= expected : allocations == expected) && text == expectedText;
+    std::cout << (passed ? "PASS " : "FAIL ") << name << ": " << allocations << " allocations" << std::endl;
+    if (!passed) {
+        ++failures;
+    }
+}
+
+int main() {
+    const std::string first = "Hello, this is a long first part";
+    const std::string second = "and this is a long second part";
+    const std::string name = "Alice Abernathy-Longname";
+    const int age = 30;
+    const std::string joined = first + " " + second;
+    const std::string details = name + ", Age: " + std::to_string(age);
+
+    // The operator+ chains must allocate more than once, or the checks prove nothing
+    check("control: str1 + \" \" + str2", joined, 2, [&] { return first + " " + second; }, true);
+    check("control: name + \", Age: \" + std::to_string(age)", details, 2,
+          [&] { return name + ", Age: " + std::to_string(age); }, true);
+
+    check("concat(str1, \" \", str2)", joined, 1, [&] { return concat(first, " ", second); });
+    check("concat(name, \", Age: \", age)", details, 1, [&] { return concat(name, ", Age: ", age); });
+    check("concat with a short result (small-string buffer)", "id-42", 0, [&] { return concat("id-", 42); });
+    check("concat of every kind of part", "x -7 18446744073709551615 y", 1, [&] {
+        return concat(std::string_view("x"), ' ', -7, ' ', 18446744073709551615ull, " y", "");
+    });
+
+    // A reused string keeps its capacity: one allocation for the first line, none after
+    std::string line;
+    check("appendConcat into a new string", details, 1, [&] {
+        appendConcat(line, name, ", Age: ", age);
+        return std::string_view(line);
+    });
+    check("appendConcat into a cleared string", details, 0, [&] {
+        line.clear();
+        appendConcat(line, name, ", Age: ", age);
+        return std::string_view(line);
+    });
+
+    char buffer[128];
+    check("concatInto a caller buffer", details, 0, [&] { return concatInto(buffer, sizeof(buffer), name, ", Age: ", age); });
+
+    bool threw = false;
+    try {
+        concatInto(buffer, 4, name);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    std::cout << (threw ? "PASS " : "FAIL ") << "concatInto throws when the buffer is too small" << std::endl;
+    if (!threw) {
+        ++failures;
+    }
+
+    std::cout << (failures == 0 ? "All checks passed." : "Some checks failed.") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
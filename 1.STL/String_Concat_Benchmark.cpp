@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "String_Concat.h"
+
+// Builds "<name>, Age: <age>" (UserProfile::getUserDetails() in 4.Google_Mock/Overall_Example.cpp)
+// for many users in four ways:
+//   - name + ", Age: " + std::to_string(age)
+//   - concat(name, ", Age: ", age)
+//   - appendConcat into one cleared and reused std::string
+//   - concatInto a stack buffer
+// The results of every method are compared with operator+; any difference is reported and
+// makes the program exit with status 1.
+//
+// Usage: String_Concat_Benchmark [iterations]
+//        (default: 10000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+int main(int argc, char** argv) {
+    std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    // Names both shorter and longer than the small-string buffer
+    const std::vector<std::string> names = {"Alice", "Bob", "Charlie Chamberlain", "Dorothy Abernathy-Longname"};
+    std::size_t checksum[4] = {};
+    bool ok = true;
+
+    double plusTime = measureSeconds(3, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const std::string& name = names[i % names.size()];
+            std::string details = name + ", Age: " + std::to_string(static_cast<int>(i % 100));
+            sum += details.size() + static_cast<unsigned char>(details.back());
+        }
+        checksum[0] = sum;
+    });
+
+    double concatTime = measureSeconds(3, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const std::string& name = names[i % names.size()];
+            std::string details = concat(name, ", Age: ", static_cast<int>(i % 100));
+            sum += details.size() + static_cast<unsigned char>(details.back());
+        }
+        checksum[1] = sum;
+    });
+
+    double appendTime = measureSeconds(3, [&] {
+        std::size_t sum = 0;
+        std::string details;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const std::string& name = names[i % names.size()];
+            details.clear();
+            appendConcat(details, name, ", Age: ", static_cast<int>(i % 100));
+            sum += details.size() + static_cast<unsigned char>(details.back());
+        }
+        checksum[2] = sum;
+    });
+
+    double bufferTime = measureSeconds(3, [&] {
+        std::size_t sum = 0;
+        char buffer[64];
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const std::string& name = names[i % names.size()];
+            std::string_view details = concatInto(buffer, sizeof(buffer), name, ", Age: ", static_cast<int>(i % 100));
+            sum += details.size() + static_cast<unsigned char>(details.back());
+        }
+        checksum[3] = sum;
+    });
+
+    // Spot check of the text itself on top of the checksums
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const std::string& name = names[i % names.size()];
+        const int age = static_cast<int>(i % 100);
+        ok = ok && concat(name, ", Age: ", age) == name + ", Age: " + std::to_string(age);
+    }
+    for (std::size_t method = 1; method < 4; ++method) {
+        ok = ok && checksum[method] == checksum[0];
+    }
+
+    const double n = static_cast<double>(iterations);
+    std::cout << "Iterations: " << iterations << std::endl;
+    std::cout << "operator+ and std::to_string: " << plusTime / n * 1e9 << " ns per string" << std::endl;
+    std::cout << "concat:                       " << concatTime / n * 1e9 << " ns per string" << std::endl;
+    std::cout << "appendConcat, reused string:  " << appendTime / n * 1e9 << " ns per string" << std::endl;
+    std::cout << "concatInto, stack buffer:     " << bufferTime / n * 1e9 << " ns per string" << std::endl;
+    std::cout << (ok ? "All methods produce the same strings." : "Results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
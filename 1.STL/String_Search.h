@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "Simd_Kernels.h"
+
+// Substring search for log scanning: one pattern with SIMD, many patterns in one pass
+//
+//     std::size_t pos = simdFind(line, "timeout");             // like line.find("timeout")
+//     MultiPatternSearcher searcher({"error", "timeout", "refused"});
+//     searcher.scan(log, [](const PatternMatch& match) { ... }); // every occurrence of every pattern
+//
+// simdFind uses the first-and-last-byte filter: the first and last byte of the needle are
+// compared against 16 (SSE2) or 32 (AVX2) positions of the haystack at once, and only
+// positions where both match are compared in full. On text that is not made of the needle's
+// bytes almost every block is rejected with two compares and a movemask. The instruction set
+// is picked once at runtime, as for the kernels in Simd_Kernels.h.
+//
+// MultiPatternSearcher is an Aho-Corasick automaton compiled into a dense transition table
+// over the byte classes the patterns use, so scanning costs one table lookup per byte
+// however many patterns there are. Running find() once per pattern costs a pass per pattern.
+//
+// Prefix and suffix checks (the StartsWith/EndsWith matchers) are a single memcmp and need
+// none of this; HasSubstr is simdFind(...) != std::string_view::npos.
+
+// Signature shared by the single-pattern kernels: position of needle in haystack, or npos.
+// needle is at least 2 bytes and no longer than haystack.
+using StringFindKernel = std::size_t (*)(const char* haystack, std::size_t n, const char* needle, std::size_t m);
+
+inline std::size_t scalarStringFind(const char* haystack, std::size_t n, const char* needle, std::size_t m) {
+    return std::string_view(haystack, n).find(std::string_view(needle, m));
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// The first-and-last-byte filter, shared with caseInsensitiveFind (Case_Insensitive.h).
+// Transform is applied to the broadcast needle bytes and to every haystack block before they
+// are compared: the identity here, ASCII lower-casing there. A candidate at position i + bit
+// has matched the first and last byte, and MiddleMatches(candidate, needle, m) decides on the
+// bytes in between. The positions after the last full block go to Tail.
+template <__m128i (*Transform)(__m128i), bool (*MiddleMatches)(const char*, const char*, std::size_t),
+          StringFindKernel Tail>
+inline std::size_t sse2FirstLastFind(const char* haystack, std::size_t n, const char* needle, std::size_t m) {
+    const __m128i first = Transform(_mm_set1_epi8(needle[0]));
+    const __m128i last = Transform(_mm_set1_epi8(needle[m - 1]));
+    const std::size_t candidates = n - m + 1;
+    std::size_t i = 0;
+    for (; i + 16 <= candidates; i += 16) {
+        __m128i a = _mm_cmpeq_epi8(first, Transform(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i))));
+        __m128i b = _mm_cmpeq_epi8(
+            last, Transform(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + m - 1))));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(a, b)));
+        while (mask != 0) {
+            const unsigned bit = lowestSetBit(mask);
+            if (MiddleMatches(haystack + i + bit, needle, m)) {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    const std::size_t tail = Tail(haystack + i, n - i, needle, m);
+    return tail == std::string_view::npos ? tail : i + tail;
+}
+
+template <__m256i (*Transform)(__m256i), bool (*MiddleMatches)(const char*, const char*, std::size_t),
+          StringFindKernel Tail>
+SIMD_TARGET_AVX2 inline std::size_t avx2FirstLastFind(const char* haystack, std::size_t n, const char* needle,
+                                                      std::size_t m) {
+    const __m256i first = Transform(_mm256_set1_epi8(needle[0]));
+    const __m256i last = Transform(_mm256_set1_epi8(needle[m - 1]));
+    const std::size_t candidates = n - m + 1;
+    std::size_t i = 0;
+    for (; i + 32 <= candidates; i += 32) {
+        __m256i a = _mm256_cmpeq_epi8(
+            first, Transform(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i))));
+        __m256i b = _mm256_cmpeq_epi8(
+            last, Transform(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + m - 1))));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(a, b)));
+        while (mask != 0) {
+            const unsigned bit = lowestSetBit(mask);
+            if (MiddleMatches(haystack + i + bit, needle, m)) {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    const std::size_t tail = Tail(haystack + i, n - i, needle, m);
+    return tail == std::string_view::npos ? tail : i + tail;
+}
+
+inline __m128i sse2Identity(__m128i x) {
+    return x;
+}
+
+SIMD_TARGET_AVX2 inline __m256i avx2Identity(__m256i x) {
+    return x;
+}
+
+inline bool middleMatches(const char* candidate, const char* needle, std::size_t m) {
+    return std::memcmp(candidate + 1, needle + 1, m - 2) == 0;
+}
+
+inline std::size_t sse2StringFind(const char* haystack, std::size_t n, const char* needle, std::size_t m) {
+    return sse2FirstLastFind<sse2Identity, middleMatches, scalarStringFind>(haystack, n, needle, m);
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2StringFind(const char* haystack, std::size_t n, const char* needle,
+                                                   std::size_t m) {
+    return avx2FirstLastFind<avx2Identity, middleMatches, sse2StringFind>(haystack, n, needle, m);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Find kernel of a level
+inline StringFindKernel stringFindKernel(SimdLevel level) {
+#ifdef SIMD_KERNELS_X86
+    return kernelsForLevel(level, scalarStringFind, sse2StringFind, avx2StringFind);
+#else
+    return kernelsForLevel(level, scalarStringFind);
+#endif
+}
+
+// Position of the first occurrence of needle in haystack at or after pos, or npos; the same
+// result as std::string_view::find
+inline std::size_t simdFind(std::string_view haystack, std::string_view needle, std::size_t pos = 0) {
+    if (pos > haystack.size() || needle.size() > haystack.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (needle.size() < 2) {
+        // Empty needles match at pos; single bytes are a memchr, which is already vectorized
+        return haystack.find(needle, pos);
+    }
+    static const StringFindKernel kernel = stringFindKernel(simdLevel());
+    const std::size_t found = kernel(haystack.data() + pos, haystack.size() - pos, needle.data(), needle.size());
+    return found == std::string_view::npos ? found : pos + found;
+}
+
+inline bool simdContains(std::string_view haystack, std::string_view needle) {
+    return simdFind(haystack, needle) != std::string_view::npos;
+}
+
+// One occurrence reported by MultiPatternSearcher
+struct PatternMatch {
+    std::size_t position; // Offset of the first byte of the occurrence in the text
+    std::size_t pattern;  // Index of the pattern in the list given to the constructor
+};
+
+// MultiPatternSearcher: finds every occurrence of any of a fixed set of patterns in one pass
+//
+// Built once from the patterns, which need not outlive it, then used for any number of
+// texts and from any number of threads. Occurrences may overlap, and a pattern that is a
+// suffix of another is reported as well. They are reported in order of their last byte.
+class MultiPatternSearcher {
+public:
+    MultiPatternSearcher(std::initializer_list<std::string_view> patterns)
+        : MultiPatternSearcher(std::vector<std::string_view>(patterns)) {
+    }
+
+    explicit MultiPatternSearcher(const std::vector<std::string_view>& patterns) {
+        for (std::string_view pattern : patterns) {
+            if (pattern.empty()) {
+                throw std::invalid_argument("MultiPatternSearcher: empty pattern");
+            }
+            lengths.push_back(pattern.size());
+        }
+        buildClasses(patterns);
+        buildAutomaton(patterns);
+    }
+
+    std::size_t patternCount() const {
+        return lengths.size();
+    }
+
+    std::size_t stateCount() const {
+        return table.size() / stride - 1;
+    }
+
+    // Calls fn(const PatternMatch&) for every occurrence
+    template <typename Fn>
+    void scan(std::string_view text, Fn fn) const {
+        const std::uint32_t* rows = table.data();
+        const std::uint16_t* byteClass = classes.data();
+        const std::size_t outputColumn = stride - 1;
+        std::uint32_t row = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            row = rows[row + byteClass[static_cast<unsigned char>(text[i])]];
+            // Most states end no pattern, so the check is one compare of two table entries
+            for (std::uint32_t j = rows[row + outputColumn]; j != rows[row + stride + outputColumn]; ++j) {
+                const std::uint32_t pattern = outputs[j];
+                fn(PatternMatch{i + 1 - lengths[pattern], pattern});
+            }
+        }
+    }
+
+    std::vector<PatternMatch> findAll(std::string_view text) const {
+        std::vector<PatternMatch> matches;
+        scan(text, [&](const PatternMatch& match) { matches.push_back(match); });
+        return matches;
+    }
+
+    // Number of occurrences of each pattern, indexed like the constructor's list
+    std::vector<std::size_t> countAll(std::string_view text) const {
+        std::vector<std::size_t> counts(lengths.size());
+        scan(text, [&](const PatternMatch& match) { ++counts[match.pattern]; });
+        return counts;
+    }
+
+    // Whether any pattern occurs; stops at the first occurrence
+    bool containsAny(std::string_view text) const {
+        const std::size_t outputColumn = stride - 1;
+        std::uint32_t row = 0;
+        for (char c : text) {
+            row = table[row + classes[static_cast<unsigned char>(c)]];
+            if (table[row + outputColumn] != table[row + stride + outputColumn]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // Bytes that appear in no pattern all share class 0, so the table only needs a column
+    // per distinct pattern byte plus one
+    void buildClasses(const std::vector<std::string_view>& patterns) {
+        classes.fill(0);
+        classCount = 1;
+        for (std::string_view pattern : patterns) {
+            for (char c : pattern) {
+                std::uint16_t& slot = classes[static_cast<unsigned char>(c)];
+                if (slot == 0) {
+                    slot = static_cast<std::uint16_t>(classCount++);
+                }
+            }
+        }
+    }
+
+    // Trie of the patterns, then failure links in breadth-first order. Missing transitions
+    // are filled in from the failure state, which turns the trie into a DFA, and each state's
+    // outputs include those of its failure state. The result is laid out as one table row per
+    // state (see table below).
+    void buildAutomaton(const std::vector<std::string_view>& patterns) {
+        constexpr std::uint32_t kNone = 0xffffffffu;
+        std::vector<std::uint32_t> trie(classCount, kNone);
+        std::vector<std::vector<std::uint32_t>> ends(1);
+        for (std::size_t p = 0; p < patterns.size(); ++p) {
+            std::uint32_t state = 0;
+            for (char c : patterns[p]) {
+                std::uint32_t& next = trie[state * classCount + classes[static_cast<unsigned char>(c)]];
+                if (next == kNone) {
+                    next = static_cast<std::uint32_t>(ends.size());
+                    ends.emplace_back();
+                    trie.resize(trie.size() + classCount, kNone);
+                }
+                state = trie[state * classCount + classes[static_cast<unsigned char>(c)]];
+            }
+            ends[state].push_back(static_cast<std::uint32_t>(p));
+        }
+
+        const std::size_t states = ends.size();
+        std::vector<std::uint32_t>& transitions = trie;
+        std::vector<std::uint32_t> failure(states, 0);
+        std::vector<std::uint32_t> order; // Breadth-first
+        order.reserve(states);
+        for (std::size_t c = 0; c < classCount; ++c) {
+            std::uint32_t& next = transitions[c];
+            if (next == kNone) {
+                next = 0;
+            } else {
+                order.push_back(next);
+            }
+        }
+        for (std::size_t head = 0; head < order.size(); ++head) {
+            const std::uint32_t state = order[head];
+            for (std::size_t c = 0; c < classCount; ++c) {
+                std::uint32_t& next = transitions[state * classCount + c];
+                const std::uint32_t fallback = transitions[failure[state] * classCount + c];
+                if (next == kNone) {
+                    next = fallback;
+                } else {
+                    failure[next] = fallback;
+                    order.push_back(next);
+                }
+            }
+        }
+
+        // Failure states come earlier in breadth-first order, so their outputs are complete
+        // by the time a state copies them
+        for (std::uint32_t state : order) {
+            const std::vector<std::uint32_t>& inherited = ends[failure[state]];
+            ends[state].insert(ends[state].end(), inherited.begin(), inherited.end());
+        }
+        stride = classCount + 1;
+        table.assign((states + 1) * stride, 0);
+        for (std::size_t state = 0; state < states; ++state) {
+            for (std::size_t c = 0; c < classCount; ++c) {
+                table[state * stride + c] = static_cast<std::uint32_t>(transitions[state * classCount + c] * stride);
+            }
+            table[state * stride + classCount] = static_cast<std::uint32_t>(outputs.size());
+            outputs.insert(outputs.end(), ends[state].begin(), ends[state].end());
+        }
+        table[states * stride + classCount] = static_cast<std::uint32_t>(outputs.size());
+    }
+
+    std::array<std::uint16_t, 256> classes; // Byte -> column of the transition table
+    std::size_t classCount = 1;
+    // One row of stride = classCount + 1 entries per state. Entry c is the offset of the row
+    // of the next state on a byte of class c, so the scan loop needs no multiply; the last
+    // entry is where the state's outputs start in outputs, and they end where the next row's
+    // start (an extra row at the end closes the last state's range).
+    std::vector<std::uint32_t> table;
+    std::size_t stride = 1;
+    std::vector<std::uint32_t> outputs;  // Pattern indices
+    std::vector<std::size_t> lengths;    // Per pattern
+};
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "String_Search.h"
+
+// Searches generated log text of 1 KB up to maxMB:
+//   - one needle that occurs only at the very end: std::string::find against simdFind at
+//     every SIMD level this machine supports
+//   - every occurrence of 16 keywords: std::string::find run once per keyword against one
+//     pass of MultiPatternSearcher
+// All methods must report the same positions and counts; any difference is reported and
+// makes the program exit with status 1.
+//
+// Usage: String_Search_Benchmark [maxMB]
+//        (default: 1024, i.e. 1 GB; the text is held in memory)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+namespace {
+
+// Lowercase words separated by spaces and newlines, with a keyword now and then
+std::string makeLog(std::size_t bytes, const std::vector<std::string_view>& keywords, std::mt19937& gen) {
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> wordLength(2, 9);
+    std::uniform_int_distribution<int> pick(0, 999);
+    std::string text;
+    text.reserve(bytes + 16);
+    while (text.size() < bytes) {
+        int roll = pick(gen);
+        if (roll < static_cast<int>(keywords.size())) {
+            text.append(keywords[static_cast<std::size_t>(roll)]);
+        } else {
+            for (int i = wordLength(gen); i > 0; --i) {
+                text.push_back(static_cast<char>(letter(gen)));
+            }
+        }
+        text.push_back(roll % 13 == 0 ? '\n' : ' ');
+    }
+    text.resize(bytes);
+    return text;
+}
+
+std::vector<std::size_t> countWithFind(const std::string& text, const std::vector<std::string_view>& keywords) {
+    std::vector<std::size_t> counts;
+    for (std::string_view keyword : keywords) {
+        std::size_t count = 0;
+        for (std::size_t pos = text.find(keyword); pos != std::string::npos; pos = text.find(keyword, pos + 1)) {
+            ++count;
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t maxMB = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    const std::string_view needle = "connection reset by peer";
+    const std::vector<std::string_view> keywords = {
+        "error",     "warning", "timeout", "refused",  "denied",   "failed",  "panic",   "abort",
+        "overflow",  "retry",   "closed",  "invalid",  "missing",  "corrupt", "deadlock", "segfault"};
+    const MultiPatternSearcher searcher(keywords);
+
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+#ifdef SIMD_KERNELS_X86
+    levels.push_back(SimdLevel::SSE2);
+    if (simdLevel() == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+#endif
+
+    std::vector<std::size_t> sizes = {1 << 10, 64 << 10, 1 << 20, 16 << 20, 256 << 20, std::size_t(1) << 30};
+    while (!sizes.empty() && sizes.back() > (maxMB << 20)) {
+        sizes.pop_back();
+    }
+
+    std::mt19937 gen(42);
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Throughput in GB/s; the scalar level is std::string_view::find" << std::endl;
+    for (std::size_t size : sizes) {
+        std::string text = makeLog(size, keywords, gen);
+        text.replace(text.size() - needle.size(), needle.size(), needle);
+        const std::size_t expected = text.size() - needle.size();
+        // Small texts are searched many times so that the timings are measurable
+        const int rounds = static_cast<int>(std::max<std::size_t>(1, (std::size_t(64) << 20) / size));
+        const double gigabytes = static_cast<double>(size) * rounds / 1e9;
+
+        std::cout << std::setw(10) << size << " bytes: find ";
+        std::size_t found = 0;
+        double findTime = measureSeconds(3, [&] {
+            for (int r = 0; r < rounds; ++r) {
+                found = text.find(needle);
+                doNotOptimize(found);
+            }
+        });
+        ok = ok && found == expected;
+        std::cout << std::setw(6) << gigabytes / findTime;
+        for (SimdLevel level : levels) {
+            StringFindKernel kernel = stringFindKernel(level);
+            double time = measureSeconds(3, [&] {
+                for (int r = 0; r < rounds; ++r) {
+                    found = kernel(text.data(), text.size(), needle.data(), needle.size());
+                    doNotOptimize(found);
+                }
+            });
+            ok = ok && found == expected;
+            std::cout << ", " << simdLevelName(level) << " " << std::setw(6) << gigabytes / time;
+        }
+
+        std::vector<std::size_t> expectedCounts;
+        double perPatternTime = measureSeconds(1, [&] {
+            for (int r = 0; r < rounds; ++r) {
+                expectedCounts = countWithFind(text, keywords);
+            }
+        });
+        std::vector<std::size_t> counts;
+        double automatonTime = measureSeconds(1, [&] {
+            for (int r = 0; r < rounds; ++r) {
+                counts = searcher.countAll(text);
+            }
+        });
+        ok = ok && counts == expectedCounts;
+        std::cout << " | " << keywords.size() << " keywords: find per keyword " << std::setw(6)
+                  << gigabytes / perPatternTime << ", automaton " << std::setw(6) << gigabytes / automatonTime
+                  << std::endl;
+    }
+
+    std::cout << (ok ? "All searches agree with std::string::find." : "Search results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
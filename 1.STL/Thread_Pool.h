@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ThreadPool: a fixed set of worker threads for data-parallel loops
+//
+// Starting a std::thread per call costs tens of microseconds, which is more than a
+// parallel loop over a few hundred thousand ints saves. ThreadPool starts its threads once
+// and then runs "task i for i in [0, taskCount)" loops on them:
+//     ThreadPool pool(4);                                  // the caller plus 3 workers
+//     pool.run(chunks, [&](std::size_t i) { ... });       // blocks until every task ran
+// Tasks are handed out through one atomic counter, so fast threads take more of them.
+// The calling thread works on the loop too, which is why a pool of size N starts N - 1
+// threads, and a pool of size 1 simply runs the loop inline.
+//
+// If a task throws, the remaining tasks still run and the first exception is rethrown
+// from run(). Calls to run() from several threads are serialized.
+class ThreadPool {
+public:
+    // Number of hardware threads, or 1 if the platform cannot tell
+    static std::size_t defaultThreadCount() {
+        unsigned count = std::thread::hardware_concurrency();
+        return count == 0 ? 1 : count;
+    }
+
+    explicit ThreadPool(std::size_t threadCount = defaultThreadCount()) {
+        for (std::size_t i = 1; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that take part in run(), including the caller
+    std::size_t size() const {
+        return workers.size() + 1;
+    }
+
+    // Calls fn(i) once for every i in [0, taskCount) and returns when all calls are done
+    template <typename Fn>
+    void run(std::size_t taskCount, Fn&& fn) {
+        if (taskCount == 0) {
+            return;
+        }
+        if (workers.empty() || taskCount == 1) {
+            for (std::size_t i = 0; i < taskCount; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+        Job job;
+        job.taskCount = taskCount;
+        job.context = &fn;
+        job.invoke = [](void* context, std::size_t i) { (*static_cast<std::remove_reference_t<Fn>*>(context))(i); };
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &job;
+            ++generation;
+        }
+        wake.notify_all();
+
+        work(job);
+
+        // Every task has been claimed; wait for the workers still running one
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return activeWorkers == 0; });
+        current = nullptr;
+        lock.unlock();
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+private:
+    struct Job {
+        std::atomic<std::size_t> next{0};
+        std::size_t taskCount = 0;
+        void* context = nullptr;
+        void (*invoke)(void*, std::size_t) = nullptr;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    static void work(Job& job) {
+        for (;;) {
+            std::size_t i = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= job.taskCount) {
+                return;
+            }
+            try {
+                job.invoke(job.context, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job.errorMutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void workerLoop() {
+        std::size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || (current != nullptr && generation != seen); });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            Job* job = current;
+            ++activeWorkers; // Keeps run() from returning while this thread uses the job
+            lock.unlock();
+            work(*job);
+            lock.lock();
+            if (--activeWorkers == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;               // Guards everything below
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Job* current = nullptr;
+    std::size_t generation = 0;
+    std::size_t activeWorkers = 0;
+    bool stopping = false;
+};
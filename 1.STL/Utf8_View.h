@@ -0,0 +1,511 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Simd_Kernels.h"
+
+// UTF-8 validation, code point counting and code-point-indexed views
+//
+// std::string::length(), substr() and operator[] count bytes, so on multilingual text they
+// split characters: "Grüße".length() is 7 and substr(0, 3) ends in half of the "ü".
+// Utf8View checks once that the bytes are valid UTF-8 and then works in code points:
+//     Utf8View text(line);                      // throws std::invalid_argument if not UTF-8
+//     text.length();                            // code points
+//     Utf8View word = text.substr(7, 2);        // code points 7 and 8, no copy
+//     std::string_view bytes = word;            // the same bytes, no copy
+//     char32_t c = text[0];
+//
+// Random access does not rescan the text: the view keeps a sparse index with the number of
+// code points before every kIndexBlock bytes, so finding code point k is a binary search in
+// the index and a walk of at most kIndexBlock bytes. The index costs one size_t per block.
+// Views cut with substr() share the index of the view they come from, so a substr is two
+// lookups and no rescan or allocation.
+// A view does not own its bytes; they must outlive it, like for std::string_view.
+//
+// Validation and counting have SSE2 and AVX2 kernels picked at runtime, as in Simd_Kernels.h:
+//  - AVX2 validates 32 bytes per step with the lookup algorithm of Keiser and Lemire
+//    ("Validating UTF-8 In Less Than One Instruction Per Byte"): three table lookups on the
+//    nibbles of each byte and its predecessor flag every invalid two-byte pattern, and a
+//    check on the bytes two and three back catches missing or extra continuation bytes
+//  - SSE2 has no byte shuffle for the lookups, so it skips all-ASCII blocks of 16 bytes and
+//    checks the others a character at a time
+//  - counting adds up the bytes that are not continuation bytes (10xxxxxx)
+
+// Valid length of the character starting at data[i], or 0 if it is not valid UTF-8
+// (Unicode table 3-7: no overlong forms, no surrogates, nothing above U+10FFFF)
+inline std::size_t utf8CharLength(const char* data, std::size_t n, std::size_t i) {
+    auto byte = [&](std::size_t k) { return static_cast<unsigned char>(data[k]); };
+    auto continuation = [&](std::size_t k, unsigned low = 0x80, unsigned high = 0xBF) {
+        return k < n && byte(k) >= low && byte(k) <= high;
+    };
+    const unsigned c = byte(i);
+    if (c < 0x80) {
+        return 1;
+    }
+    if (c >= 0xC2 && c <= 0xDF) {
+        return continuation(i + 1) ? 2 : 0;
+    }
+    if (c >= 0xE0 && c <= 0xEF) {
+        const unsigned low = c == 0xE0 ? 0xA0 : 0x80;
+        const unsigned high = c == 0xED ? 0x9F : 0xBF;
+        return continuation(i + 1, low, high) && continuation(i + 2) ? 3 : 0;
+    }
+    if (c >= 0xF0 && c <= 0xF4) {
+        const unsigned low = c == 0xF0 ? 0x90 : 0x80;
+        const unsigned high = c == 0xF4 ? 0x8F : 0xBF;
+        return continuation(i + 1, low, high) && continuation(i + 2) && continuation(i + 3) ? 4 : 0;
+    }
+    return 0;
+}
+
+// Signatures shared by the kernels of every level
+struct Utf8Kernels {
+    bool (*validate)(const char* data, std::size_t n);
+    std::size_t (*count)(const char* data, std::size_t n); // Code points; data must be valid
+};
+
+inline bool scalarUtf8Validate(const char* data, std::size_t n) {
+    for (std::size_t i = 0; i < n;) {
+        const std::size_t length = utf8CharLength(data, n, i);
+        if (length == 0) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+inline std::size_t scalarUtf8Count(const char* data, std::size_t n) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        count += (static_cast<unsigned char>(data[i]) & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+inline bool sse2Utf8Validate(const char* data, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n) {
+        if (i + 16 <= n && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) == 0) {
+            i += 16;
+            continue;
+        }
+        // Characters are checked one by one across the block, then ASCII skipping resumes
+        for (const std::size_t end = std::min(i + 16, n); i < end;) {
+            const std::size_t length = utf8CharLength(data, n, i);
+            if (length == 0) {
+                return false;
+            }
+            i += length;
+        }
+    }
+    return true;
+}
+
+// Non-continuation bytes are the ones greater than 0xBF as signed bytes (-65). Each block
+// subtracts -1 per such byte from byte counters, which are added into 64-bit totals with
+// _mm_sad_epu8 before they can overflow (255 blocks).
+inline std::size_t sse2Utf8Count(const char* data, std::size_t n) {
+    const __m128i limit = _mm_set1_epi8(-65);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i counters = _mm_setzero_si128();
+        for (int blocks = 0; blocks < 255 && i + 16 <= n; ++blocks, i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(x, limit));
+        }
+        __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        // Each half holds at most 255 * 8, so the low 16 bits of the upper half are enough
+        count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums)) +
+                 static_cast<std::size_t>(_mm_extract_epi16(sums, 4));
+    }
+    return count + scalarUtf8Count(data + i, n - i);
+}
+
+// Error classes of the lookup algorithm; a bit survives the three lookups only if both bytes
+// of a pair show that error
+namespace utf8_lookup {
+constexpr std::uint8_t kTooShort = 1 << 0;   // Lead byte followed by a lead byte or ASCII
+constexpr std::uint8_t kTooLong = 1 << 1;    // ASCII followed by a continuation byte
+constexpr std::uint8_t kOverlong3 = 1 << 2;  // 11100000 100xxxxx
+constexpr std::uint8_t kTooLarge = 1 << 3;   // 11110100 1001xxxx, 11110100 101xxxxx, 11110101 and up
+constexpr std::uint8_t kSurrogate = 1 << 4;  // 11101101 101xxxxx
+constexpr std::uint8_t kOverlong2 = 1 << 5;  // 1100000x 10xxxxxx
+constexpr std::uint8_t kTooLarge1000 = 1 << 6; // 11110101 and up followed by 1000xxxx
+constexpr std::uint8_t kOverlong4 = 1 << 6;  // 11110000 1000xxxx
+constexpr std::uint8_t kTwoConts = 1 << 7;   // Continuation byte after a continuation byte
+constexpr std::uint8_t kCarry = kTooShort | kTooLong | kTwoConts; // Decided by the high nibble alone
+} // namespace utf8_lookup
+
+// The 16-entry table in both 128-bit lanes, for _mm256_shuffle_epi8
+SIMD_TARGET_AVX2 inline __m256i avx2Table(std::uint8_t e0, std::uint8_t e1, std::uint8_t e2, std::uint8_t e3,
+                                          std::uint8_t e4, std::uint8_t e5, std::uint8_t e6, std::uint8_t e7,
+                                          std::uint8_t e8, std::uint8_t e9, std::uint8_t e10, std::uint8_t e11,
+                                          std::uint8_t e12, std::uint8_t e13, std::uint8_t e14, std::uint8_t e15) {
+    const __m128i lane = _mm_setr_epi8(static_cast<char>(e0), static_cast<char>(e1), static_cast<char>(e2),
+                                       static_cast<char>(e3), static_cast<char>(e4), static_cast<char>(e5),
+                                       static_cast<char>(e6), static_cast<char>(e7), static_cast<char>(e8),
+                                       static_cast<char>(e9), static_cast<char>(e10), static_cast<char>(e11),
+                                       static_cast<char>(e12), static_cast<char>(e13), static_cast<char>(e14),
+                                       static_cast<char>(e15));
+    return _mm256_broadcastsi128_si256(lane);
+}
+
+// The 32 bytes ending n bytes before the end of input: the last n of previous, then input
+template <int n>
+SIMD_TARGET_AVX2 inline __m256i avx2Previous(__m256i input, __m256i previous) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - n);
+}
+
+SIMD_TARGET_AVX2 inline __m256i avx2HighNibbles(__m256i x) {
+    return _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0F));
+}
+
+SIMD_TARGET_AVX2 inline bool avx2Utf8Validate(const char* data, std::size_t n) {
+    using namespace utf8_lookup;
+    const __m256i byte1High = avx2Table(
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, // 0xxx: ASCII
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,                                     // 10xx: continuation
+        kTooShort | kOverlong2,                                                         // 1100
+        kTooShort,                                                                      // 1101
+        kTooShort | kOverlong3 | kSurrogate,                                            // 1110
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4);                            // 1111
+    const __m256i byte1Low = avx2Table(
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4, // xxxx0000
+        kCarry | kOverlong2,                           // xxxx0001
+        kCarry, kCarry,                                // xxxx001x
+        kCarry | kTooLarge,                            // xxxx0100
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate, // xxxx1101
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000);
+    const __m256i byte2High = avx2Table(
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, // 0xxx
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,            // 1000
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,                             // 1001
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                             // 1010
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                             // 1011
+        kTooShort, kTooShort, kTooShort, kTooShort);                                            // 11xx
+    // Bytes that would need more bytes after them if they were the last of the input
+    const __m256i incompleteLimit = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+
+    __m256i error = _mm256_setzero_si256();
+    __m256i previous = _mm256_setzero_si256();
+    __m256i previousIncomplete = _mm256_setzero_si256();
+    alignas(32) char padded[32];
+    for (std::size_t i = 0; i < n; i += 32) {
+        __m256i input;
+        if (i + 32 <= n) {
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        } else {
+            // The last block is padded with zeros, which are ASCII and end any open character
+            std::memset(padded, 0, sizeof(padded));
+            std::memcpy(padded, data + i, n - i);
+            input = _mm256_load_si256(reinterpret_cast<const __m256i*>(padded));
+        }
+        if (_mm256_movemask_epi8(input) == 0) {
+            // All ASCII: only a character left open by the previous block can be wrong
+            error = _mm256_or_si256(error, previousIncomplete);
+        } else {
+            const __m256i previous1 = avx2Previous<1>(input, previous);
+            __m256i special = _mm256_and_si256(
+                _mm256_and_si256(_mm256_shuffle_epi8(byte1High, avx2HighNibbles(previous1)),
+                                 _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(previous1, lowNibble))),
+                _mm256_shuffle_epi8(byte2High, avx2HighNibbles(input)));
+            // The third byte of a 3- or 4-byte character and the fourth of a 4-byte one must
+            // be continuations; kTwoConts (0x80) was set for them above and is cleared here
+            const __m256i third = _mm256_subs_epu8(avx2Previous<2>(input, previous), _mm256_set1_epi8(0xE0 - 0x80));
+            const __m256i fourth = _mm256_subs_epu8(avx2Previous<3>(input, previous), _mm256_set1_epi8(0xF0 - 0x80));
+            const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            error = _mm256_or_si256(error, _mm256_xor_si256(mustContinue, special));
+            previousIncomplete = _mm256_subs_epu8(input, incompleteLimit);
+        }
+        previous = input;
+    }
+    error = _mm256_or_si256(error, previousIncomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+SIMD_TARGET_AVX2 inline std::size_t avx2Utf8Count(const char* data, std::size_t n) {
+    const __m256i limit = _mm256_set1_epi8(-65);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + 32 <= n) {
+        __m256i counters = _mm256_setzero_si256();
+        for (int blocks = 0; blocks < 255 && i + 32 <= n; ++blocks, i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(x, limit));
+        }
+        alignas(32) std::uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+        count += static_cast<std::size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+    }
+    return count + sse2Utf8Count(data + i, n - i);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Validation and counting kernels of a level
+inline const Utf8Kernels& utf8Kernels(SimdLevel level) {
+    static const Utf8Kernels scalar = {scalarUtf8Validate, scalarUtf8Count};
+#ifdef SIMD_KERNELS_X86
+    static const Utf8Kernels sse2 = {sse2Utf8Validate, sse2Utf8Count};
+    static const Utf8Kernels avx2 = {avx2Utf8Validate, avx2Utf8Count};
+    return kernelsForLevel(level, scalar, sse2, avx2);
+#else
+    return kernelsForLevel(level, scalar);
+#endif
+}
+
+inline const Utf8Kernels& utf8Kernels() {
+    static const Utf8Kernels& kernels = utf8Kernels(simdLevel());
+    return kernels;
+}
+
+inline bool isValidUtf8(std::string_view text) {
+    return utf8Kernels().validate(text.data(), text.size());
+}
+
+// Number of code points in text, which must be valid UTF-8
+inline std::size_t utf8Length(std::string_view text) {
+    return utf8Kernels().count(text.data(), text.size());
+}
+
+// Code point starting at p, which must be the start of a valid character
+inline char32_t decodeUtf8(const char* p) {
+    const unsigned c = static_cast<unsigned char>(p[0]);
+    auto next = [&](int k) { return static_cast<char32_t>(static_cast<unsigned char>(p[k]) & 0x3F); };
+    if (c < 0x80) {
+        return c;
+    }
+    if (c < 0xE0) {
+        return (static_cast<char32_t>(c & 0x1F) << 6) | next(1);
+    }
+    if (c < 0xF0) {
+        return (static_cast<char32_t>(c & 0x0F) << 12) | (next(1) << 6) | next(2);
+    }
+    return (static_cast<char32_t>(c & 0x07) << 18) | (next(1) << 12) | (next(2) << 6) | next(3);
+}
+
+class Utf8View {
+public:
+    static constexpr std::size_t npos = std::string_view::npos;
+
+    // Bytes per index entry: the longest walk a lookup makes
+    static constexpr std::size_t kIndexBlock = 256;
+
+    // Code points of the view, in order
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char32_t*;
+        using reference = char32_t;
+
+        Iterator() = default;
+
+        char32_t operator*() const {
+            return decodeUtf8(position);
+        }
+
+        Iterator& operator++() {
+            do {
+                ++position;
+            } while (position != end && (static_cast<unsigned char>(*position) & 0xC0) == 0x80);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return position == other.position;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return position != other.position;
+        }
+
+    private:
+        friend class Utf8View;
+
+        Iterator(const char* position, const char* end) : position(position), end(end) {}
+
+        const char* position = nullptr;
+        const char* end = nullptr;
+    };
+
+    Utf8View() = default;
+
+    // Throws std::invalid_argument if bytes is not valid UTF-8
+    explicit Utf8View(std::string_view bytes) : text(bytes) {
+        if (!isValidUtf8(bytes)) {
+            throw std::invalid_argument("Utf8View: invalid UTF-8");
+        }
+        buildIndex();
+    }
+
+    // Number of code points
+    std::size_t length() const {
+        return codePoints;
+    }
+
+    bool empty() const {
+        return text.empty();
+    }
+
+    std::size_t byteLength() const {
+        return text.size();
+    }
+
+    std::string_view bytes() const {
+        return text;
+    }
+
+    operator std::string_view() const {
+        return text;
+    }
+
+    // Code point number pos; pos must be less than length()
+    char32_t operator[](std::size_t pos) const {
+        return decodeUtf8(text.data() + byteOffset(pos));
+    }
+
+    char32_t at(std::size_t pos) const {
+        if (pos >= codePoints) {
+            throw std::out_of_range("Utf8View::at: position out of range");
+        }
+        return (*this)[pos];
+    }
+
+    // count code points from pos (fewer if the text ends first), as a view of the same bytes
+    Utf8View substr(std::size_t pos = 0, std::size_t count = npos) const {
+        if (pos > codePoints) {
+            throw std::out_of_range("Utf8View::substr: position out of range");
+        }
+        count = std::min(count, codePoints - pos);
+        const std::size_t first = byteOffset(pos);
+        // Short pieces are cheaper to walk than to look up a second time
+        std::size_t last = first;
+        if (count <= kIndexBlock) {
+            for (std::size_t left = count; left > 0; --left) {
+                do {
+                    ++last;
+                } while (last < text.size() && (static_cast<unsigned char>(text[last]) & 0xC0) == 0x80);
+            }
+        } else {
+            last = byteOffset(pos + count);
+        }
+        Utf8View piece;
+        piece.text = text.substr(first, last - first);
+        piece.codePoints = count;
+        piece.blockCounts = blockCounts;
+        piece.indexOffset = indexOffset + first;
+        piece.indexCodePoints = indexCodePoints + pos;
+        return piece;
+    }
+
+    // Code point index of the first occurrence of needle (valid UTF-8) at or after code point
+    // pos, or npos
+    std::size_t find(std::string_view needle, std::size_t pos = 0) const {
+        if (pos > codePoints) {
+            return npos;
+        }
+        const std::size_t found = text.find(needle, byteOffset(pos));
+        return found == std::string_view::npos ? npos : codePointIndex(found);
+    }
+
+    // Byte offset of code point pos; pos == length() gives byteLength()
+    std::size_t byteOffset(std::size_t pos) const {
+        if (pos >= codePoints) {
+            return text.size();
+        }
+        // Last block of the indexed text that starts with at most pos code points before it
+        const char* indexed = text.data() - indexOffset;
+        const std::size_t target = indexCodePoints + pos;
+        const std::size_t block = blockCounts ? static_cast<std::size_t>(
+            std::upper_bound(blockCounts->begin(), blockCounts->end(), target) - blockCounts->begin()) : 0;
+        std::size_t remaining = target - (block == 0 ? 0 : (*blockCounts)[block - 1]);
+        std::size_t i = block * kIndexBlock;
+        // Continuation bytes at the start of the block belong to a character counted earlier
+        while ((static_cast<unsigned char>(indexed[i]) & 0xC0) == 0x80) {
+            ++i;
+        }
+        for (;; ++i) {
+            if ((static_cast<unsigned char>(indexed[i]) & 0xC0) != 0x80) {
+                if (remaining == 0) {
+                    return i - indexOffset;
+                }
+                --remaining;
+            }
+        }
+    }
+
+    // Number of code points that start before byte offset
+    std::size_t codePointIndex(std::size_t offset) const {
+        const std::size_t target = indexOffset + std::min(offset, text.size());
+        const std::size_t block = blockCounts ? std::min(target / kIndexBlock, blockCounts->size()) : 0;
+        const std::size_t start = block * kIndexBlock;
+        const std::size_t before = (block == 0 ? 0 : (*blockCounts)[block - 1]) +
+                                   scalarUtf8Count(text.data() - indexOffset + start, target - start);
+        return before - indexCodePoints;
+    }
+
+    Iterator begin() const {
+        return Iterator(text.data(), text.data() + text.size());
+    }
+
+    Iterator end() const {
+        return Iterator(text.data() + text.size(), text.data() + text.size());
+    }
+
+private:
+    void buildIndex() {
+        const Utf8Kernels& kernels = utf8Kernels();
+        std::vector<std::size_t> counts;
+        if (text.size() > kIndexBlock) {
+            counts.reserve((text.size() - 1) / kIndexBlock);
+        }
+        codePoints = 0;
+        for (std::size_t start = 0; start < text.size(); start += kIndexBlock) {
+            if (start > 0) {
+                counts.push_back(codePoints);
+            }
+            codePoints += kernels.count(text.data() + start, std::min(kIndexBlock, text.size() - start));
+        }
+        if (!counts.empty()) {
+            blockCounts = std::make_shared<const std::vector<std::size_t>>(std::move(counts));
+        }
+    }
+
+    std::string_view text;
+    std::size_t codePoints = 0;
+    // Index of the text the view was validated on, which substr() views share: [b - 1] is the
+    // number of code points that start before byte b * kIndexBlock of that text. Null if it
+    // fits in one block. The view starts indexOffset bytes and indexCodePoints code points
+    // into that text.
+    std::shared_ptr<const std::vector<std::size_t>> blockCounts;
+    std::size_t indexOffset = 0;
+    std::size_t indexCodePoints = 0;
+};
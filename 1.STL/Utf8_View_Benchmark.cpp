@@ -0,0 +1,134 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Utf8_View.h"
+
+// Measures the kernels of Utf8_View.h at every SIMD level this machine supports on two
+// generated texts, mostly-ASCII (log lines with a few accented words) and multilingual
+// (Latin, Cyrillic, CJK and emoji mixed):
+//   - validation and code point counting, in GB/s
+//   - code-point-indexed substr through the sparse index, against walking from the start of
+//     the text for every access, which is what a view without an index has to do
+// Every level must agree with the scalar kernels, a copy of each text with one broken byte
+// must be rejected, and every indexed access must match the walk; any difference is
+// reported and makes the program exit with status 1.
+//
+// Usage: Utf8_View_Benchmark [textMB] [accesses]
+//        (defaults: 64 and 1000000)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+namespace {
+
+std::string makeText(std::size_t bytes, bool multilingual, std::mt19937& gen) {
+    const std::vector<std::string_view> ascii = {"request", "served", "in", "ms", "user", "id", "ok", "GET", "/index"};
+    const std::vector<std::string_view> accented = {"Grüße", "café", "naïve", "déjà", "Ångström"};
+    const std::vector<std::string_view> other = {"Привет", "мир", "世界", "你好", "こんにちは", "😀", "🚀", "Ελλάδα"};
+    std::uniform_int_distribution<int> roll(0, 99);
+    std::string text;
+    text.reserve(bytes + 64);
+    while (text.size() < bytes) {
+        const int r = roll(gen);
+        if (multilingual ? r < 30 : r < 95) {
+            text.append(ascii[gen() % ascii.size()]);
+        } else if (multilingual ? r < 50 : true) {
+            text.append(accented[gen() % accented.size()]);
+        } else {
+            text.append(other[gen() % other.size()]);
+        }
+        text.push_back(r % 16 == 0 ? '\n' : ' ');
+    }
+    // Cut at a character boundary
+    std::size_t end = bytes;
+    while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    text.resize(end);
+    return text;
+}
+
+// Byte offset of code point pos found by walking from the start
+std::size_t walkToCodePoint(std::string_view text, std::size_t pos) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80 && pos-- == 0) {
+            return i;
+        }
+    }
+    return text.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t textMB = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::size_t accesses = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+#ifdef SIMD_KERNELS_X86
+    levels.push_back(SimdLevel::SSE2);
+    if (simdLevel() == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+#endif
+
+    std::mt19937 gen(42);
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (bool multilingual : {false, true}) {
+        const std::string text = makeText(textMB << 20, multilingual, gen);
+        std::string broken = text;
+        broken[broken.size() / 2 + 1] = '\xC0';
+        const double gigabytes = static_cast<double>(text.size()) / 1e9;
+        const std::size_t expectedCount = scalarUtf8Count(text.data(), text.size());
+
+        std::cout << (multilingual ? "Multilingual" : "Mostly ASCII") << " text, " << text.size() << " bytes, "
+                  << expectedCount << " code points" << std::endl;
+        for (SimdLevel level : levels) {
+            const Utf8Kernels& kernels = utf8Kernels(level);
+            bool valid = false;
+            std::size_t count = 0;
+            double validateTime = measureSeconds(3, [&] { valid = kernels.validate(text.data(), text.size()); });
+            double countTime = measureSeconds(3, [&] { count = kernels.count(text.data(), text.size()); });
+            ok = ok && valid && count == expectedCount && !kernels.validate(broken.data(), broken.size());
+            std::cout << "  " << std::setw(6) << simdLevelName(level) << ": validate " << std::setw(6)
+                      << gigabytes / validateTime << " GB/s, count " << std::setw(6) << gigabytes / countTime
+                      << " GB/s" << std::endl;
+        }
+
+        Utf8View view;
+        double buildTime = measureSeconds(1, [&] { view = Utf8View(text); });
+        std::uniform_int_distribution<std::size_t> position(0, view.length() - 1);
+        std::vector<std::size_t> positions(accesses);
+        for (std::size_t& pos : positions) {
+            pos = position(gen);
+        }
+        std::size_t checksum = 0;
+        double indexedTime = measureSeconds(3, [&] {
+            checksum = 0;
+            for (std::size_t pos : positions) {
+                std::string_view piece = view.substr(pos, 8);
+                checksum += piece.size() + static_cast<unsigned char>(piece[0]);
+            }
+        });
+        // Walking is far slower, so it only does a few accesses and checks them
+        const std::size_t walks = std::min<std::size_t>(accesses, 200);
+        double walkTime = measureSeconds(1, [&] {
+            for (std::size_t i = 0; i < walks; ++i) {
+                const std::size_t offset = walkToCodePoint(text, positions[i]);
+                ok = ok && offset == view.byteOffset(positions[i]) && view.codePointIndex(offset) == positions[i];
+            }
+        });
+        doNotOptimize(checksum);
+        std::cout << "  Utf8View: built in " << buildTime * 1e3 << " ms (validation and index), substr "
+                  << indexedTime / static_cast<double>(accesses) * 1e9 << " ns per access; walking from the start "
+                  << walkTime / static_cast<double>(walks) * 1e6 << " us per access" << std::endl;
+    }
+
+    std::cout << (ok ? "All levels agree and every access matches." : "Results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
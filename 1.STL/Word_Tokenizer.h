@@ -0,0 +1,328 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "Mapped_File.h"
+#include "Simd_Kernels.h"
+
+// Word tokenizer with the semantics of std::regex("\\b\\w+\\b"), without std::regex
+//
+// \w is [A-Za-z0-9_] (in the "C" locale, which std::regex uses unless told otherwise), and
+// \b\w+\b matches exactly the maximal runs of such bytes. That is a two-state automaton,
+// "inside a word" and "outside", which only moves on the class of each byte. Instead of
+// running it one byte at a time, the tokenizer classifies 64 bytes at once into a bit mask
+// (bit i set if byte i is a word byte) and gets every state change from the mask:
+//     starts = mask & ~(mask << 1 | carry)        // word byte after a non-word byte
+//     ends   = ~mask & (mask << 1 | carry)        // non-word byte after a word byte
+// where carry is the last bit of the previous block, so words can cross blocks. The words
+// are then read off with count-trailing-zeros, and counting them is a popcount per block.
+//
+//     for (std::string_view word : WordTokenizer(text)) { ... }   // no allocation
+//     forEachWord(text, [](std::string_view word) { ... });
+//     std::size_t words = countWords(text);
+//     MappedFile file("big.log", MappedFileAccess::Sequential);   // memory-mapped, any size
+//     forEachWord(file.text(), ...);
+// The words are views into the text, so they stay valid as long as the text does.
+//
+// The masks come from one of three kernels picked at runtime, as in Simd_Kernels.h: a
+// 256-entry class table (scalar), or range compares on 16 (SSE2) or 32 (AVX2) bytes at a
+// time turned into bits with movemask. Bytes 0x80 and above (UTF-8) are not word bytes,
+// as for std::regex.
+
+// True for the bytes of \w: letters, digits and '_'
+constexpr std::array<bool, 256> makeWordByteTable() {
+    std::array<bool, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+    }
+    return table;
+}
+
+inline constexpr std::array<bool, 256> kWordByte = makeWordByteTable();
+
+inline bool isWordByte(char c) {
+    return kWordByte[static_cast<unsigned char>(c)];
+}
+
+// Bytes classified per kernel call
+constexpr std::size_t kWordBlock = 64;
+
+// One implementation of the classifier: bit i of the result is set if block[i] is a word
+// byte; block has kWordBlock readable bytes
+struct WordKernels {
+    std::uint64_t (*wordMask)(const char* block);
+};
+
+inline std::uint64_t scalarWordMask(const char* block) {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < kWordBlock; ++i) {
+        mask |= static_cast<std::uint64_t>(kWordByte[static_cast<unsigned char>(block[i])]) << i;
+    }
+    return mask;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// All ones in the lanes that are word bytes. The compares are signed, so bytes 0x80 and
+// above are negative and fall outside every range. Setting bit 0x20 maps 'A'-'Z' onto
+// 'a'-'z' and moves no other byte into that range.
+inline __m128i sse2WordBytes(__m128i x) {
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
+    const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+    const __m128i letter =
+        _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    const __m128i underscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(digit, letter), underscore);
+}
+
+inline std::uint64_t sse2WordMask(const char* block) {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < kWordBlock; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        mask |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(sse2WordBytes(x)))) << i;
+    }
+    return mask;
+}
+
+SIMD_TARGET_AVX2 inline __m256i avx2WordBytes(__m256i x) {
+    const __m256i digit =
+        _mm256_andnot_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('9')), _mm256_cmpgt_epi8(x, _mm256_set1_epi8('0' - 1)));
+    const __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+    const __m256i letter = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('z')),
+                                               _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+    const __m256i underscore = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(digit, letter), underscore);
+}
+
+SIMD_TARGET_AVX2 inline std::uint64_t avx2WordMask(const char* block) {
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    const auto lowMask = static_cast<std::uint32_t>(_mm256_movemask_epi8(avx2WordBytes(low)));
+    const auto highMask = static_cast<std::uint32_t>(_mm256_movemask_epi8(avx2WordBytes(high)));
+    return static_cast<std::uint64_t>(highMask) << 32 | lowMask;
+}
+
+#endif // SIMD_KERNELS_X86
+
+// Classifier of a level
+inline const WordKernels& wordKernels(SimdLevel level) {
+    static const WordKernels scalar = {scalarWordMask};
+#ifdef SIMD_KERNELS_X86
+    static const WordKernels sse2 = {sse2WordMask};
+    static const WordKernels avx2 = {avx2WordMask};
+    return kernelsForLevel(level, scalar, sse2, avx2);
+#else
+    return kernelsForLevel(level, scalar);
+#endif
+}
+
+inline const WordKernels& wordKernels() {
+    static const WordKernels& kernels = wordKernels(simdLevel());
+    return kernels;
+}
+
+inline unsigned popCount64(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // __popcnt64 needs a CPU with POPCNT, so MSVC gets the bit-parallel count
+    mask -= (mask >> 1) & 0x5555555555555555ull;
+    mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((mask * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+}
+
+// Pulls the words of a text one at a time; the state of the automaton between calls is
+// the position of the current block, its unread start and end bits, and the start of a
+// word whose end has not been seen yet
+class WordScanner {
+public:
+    explicit WordScanner(std::string_view text, const WordKernels& kernels = wordKernels())
+        : text(text), kernels(&kernels) {}
+
+    // Stores the next word in word and returns true, or returns false at the end of the text
+    bool next(std::string_view& word) {
+        for (;;) {
+            if (wordStart == kNone) {
+                if (starts == 0) {
+                    if (!loadBlock()) {
+                        return false;
+                    }
+                    continue;
+                }
+                wordStart = blockStart + lowestSetBit(starts);
+                starts &= starts - 1;
+            }
+            if (ends == 0) {
+                if (!loadBlock()) {
+                    // The text ends inside the word
+                    word = text.substr(wordStart);
+                    wordStart = kNone;
+                    return true;
+                }
+                continue;
+            }
+            const std::size_t wordEnd = blockStart + lowestSetBit(ends);
+            ends &= ends - 1;
+            word = text.substr(wordStart, wordEnd - wordStart);
+            wordStart = kNone;
+            return true;
+        }
+    }
+
+private:
+    static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+    // Classifies the next block; false if the text has no more bytes
+    bool loadBlock() {
+        const std::size_t start = nextBlock;
+        if (start >= text.size()) {
+            return false;
+        }
+        std::uint64_t mask;
+        if (text.size() - start >= kWordBlock) {
+            mask = kernels->wordMask(text.data() + start);
+        } else {
+            // The last, partial block is copied into a buffer padded with non-word bytes
+            char padded[kWordBlock] = {};
+            std::memcpy(padded, text.data() + start, text.size() - start);
+            mask = kernels->wordMask(padded);
+        }
+        const std::uint64_t previous = mask << 1 | carry;
+        starts = mask & ~previous;
+        ends = ~mask & previous;
+        carry = mask >> 63;
+        blockStart = start;
+        nextBlock = start + kWordBlock;
+        return true;
+    }
+
+    std::string_view text;
+    const WordKernels* kernels;
+    std::size_t nextBlock = 0;
+    std::size_t blockStart = 0;
+    std::uint64_t starts = 0;
+    std::uint64_t ends = 0;
+    std::uint64_t carry = 0;
+    std::size_t wordStart = kNone;
+};
+
+// Calls fn(std::string_view word) for every match of \b\w+\b in text, in order.
+// Does the same as a WordScanner loop, with the automaton state kept in locals.
+template <typename Fn>
+void forEachWord(std::string_view text, Fn&& fn, const WordKernels& kernels = wordKernels()) {
+    const char* data = text.data();
+    const std::size_t n = text.size();
+    std::size_t wordStart = 0;
+    std::uint64_t carry = 0; // 1 while a word is open across a block boundary
+    for (std::size_t blockStart = 0; blockStart < n; blockStart += kWordBlock) {
+        std::uint64_t mask;
+        if (n - blockStart >= kWordBlock) {
+            mask = kernels.wordMask(data + blockStart);
+        } else {
+            char padded[kWordBlock] = {};
+            std::memcpy(padded, data + blockStart, n - blockStart);
+            mask = kernels.wordMask(padded);
+        }
+        const std::uint64_t previous = mask << 1 | carry;
+        std::uint64_t starts = mask & ~previous;
+        std::uint64_t ends = ~mask & previous;
+        carry = mask >> 63;
+        // Starts and ends alternate; a word left open by the last block ends first
+        if (previous & 1) {
+            if (ends == 0) {
+                continue;
+            }
+            const std::size_t wordEnd = blockStart + lowestSetBit(ends);
+            ends &= ends - 1;
+            fn(std::string_view(data + wordStart, wordEnd - wordStart));
+        }
+        while (starts != 0) {
+            wordStart = blockStart + lowestSetBit(starts);
+            starts &= starts - 1;
+            if (ends == 0) {
+                break; // Ends in a later block
+            }
+            const std::size_t wordEnd = blockStart + lowestSetBit(ends);
+            ends &= ends - 1;
+            fn(std::string_view(data + wordStart, wordEnd - wordStart));
+        }
+    }
+    if (carry != 0) {
+        fn(std::string_view(data + wordStart, n - wordStart));
+    }
+}
+
+// Number of matches of \b\w+\b in text: one per word start
+inline std::size_t countWords(std::string_view text, const WordKernels& kernels = wordKernels()) {
+    std::size_t count = 0;
+    std::uint64_t carry = 0;
+    std::size_t i = 0;
+    for (; i + kWordBlock <= text.size(); i += kWordBlock) {
+        const std::uint64_t mask = kernels.wordMask(text.data() + i);
+        count += popCount64(mask & ~(mask << 1 | carry));
+        carry = mask >> 63;
+    }
+    if (i < text.size()) {
+        char padded[kWordBlock] = {};
+        std::memcpy(padded, text.data() + i, text.size() - i);
+        const std::uint64_t mask = kernels.wordMask(padded);
+        count += popCount64(mask & ~(mask << 1 | carry));
+    }
+    return count;
+}
+
+// The words of a text as a range, like std::sregex_iterator without the allocations:
+//     for (std::string_view word : WordTokenizer(text)) { ... }
+class WordTokenizer {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        Iterator() = default; // The end
+
+        const std::string_view& operator*() const { return word; }
+        const std::string_view* operator->() const { return &word; }
+        Iterator& operator++() { advance(); return *this; }
+        Iterator operator++(int) { Iterator copy = *this; advance(); return copy; }
+        // Only comparisons with the end are meaningful, as for stream iterators
+        bool operator==(const Iterator& other) const { return atEnd == other.atEnd; }
+        bool operator!=(const Iterator& other) const { return atEnd != other.atEnd; }
+
+    private:
+        friend class WordTokenizer;
+
+        Iterator(std::string_view text, const WordKernels& kernels) : scanner(text, kernels), atEnd(false) {
+            advance();
+        }
+
+        void advance() {
+            atEnd = !scanner.next(word);
+        }
+
+        WordScanner scanner{std::string_view()};
+        std::string_view word;
+        bool atEnd = true;
+    };
+
+    explicit WordTokenizer(std::string_view text, const WordKernels& kernels = wordKernels())
+        : text(text), kernels(&kernels) {}
+
+    Iterator begin() const { return Iterator(text, *kernels); }
+    Iterator end() const { return Iterator(); }
+
+private:
+    std::string_view text;
+    const WordKernels* kernels;
+};
@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark_Timer.h"
+#include "Word_Tokenizer.h"
+
+// Compares the word extraction of More_Topics.cpp, std::sregex_iterator with
+// std::regex("(\\b\\w+\\b)") and match.str() for every word, with Word_Tokenizer.h on a
+// generated text of words, numbers, identifiers with '_', punctuation and UTF-8 words
+// (whose non-ASCII bytes split them, as for std::regex):
+//   - std::regex on the first regexMB of the text, which is all it can do in reasonable time
+//   - forEachWord and countWords with the kernels of every SIMD level this machine supports,
+//     and the WordTokenizer range, on the whole text
+//   - forEachWord on the same text written to a file and memory-mapped with MappedFile (Mapped_File.h)
+// The tokenizer must produce exactly the words of std::regex (same positions and lengths)
+// on the regex prefix, and every method must give the same count and checksum on the
+// whole text; any difference is reported and makes the program exit with status 1.
+//
+// Usage: Word_Tokenizer_Benchmark [textMB] [regexMB]
+//        (defaults: 256 and 8; the text is also written to a temporary file of textMB)
+// Build with optimizations, e.g. g++ -std=c++17 -O3
+
+namespace {
+
+std::string makeText(std::size_t bytes, std::mt19937& gen) {
+    const std::vector<std::string> words = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+                                            "request_id", "HTTP", "GET", "2024", "x86_64", "Grüße", "café",
+                                            "naïve", "世界", "_", "a", "extraordinarily"};
+    const std::vector<std::string> separators = {" ", " ", " ", ", ", ". ", "\n", " - ", "(", ") ", ": ", "/", "'"};
+    std::string text;
+    text.reserve(bytes + 64);
+    while (text.size() < bytes) {
+        text += words[gen() % words.size()];
+        text += separators[gen() % separators.size()];
+    }
+    text.resize(bytes);
+    return text;
+}
+
+// Adds a word to a checksum that depends on its position and length
+std::size_t mix(std::size_t checksum, std::size_t position, std::size_t length) {
+    return checksum * 31 + position * 7 + length;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t textMB = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    std::size_t regexMB = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+#ifdef SIMD_KERNELS_X86
+    levels.push_back(SimdLevel::SSE2);
+    if (simdLevel() == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+#endif
+
+    std::mt19937 gen(42);
+    const std::string text = makeText(textMB << 20, gen);
+    const std::string prefix = text.substr(0, std::min(text.size(), regexMB << 20));
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(3);
+
+    // std::regex on the prefix, as in More_Topics.cpp
+    std::vector<std::pair<std::size_t, std::size_t>> regexWords;
+    const std::regex wordRegex("(\\b\\w+\\b)");
+    std::size_t regexBytes = 0;
+    double regexTime = measureSeconds(1, [&] {
+        regexWords.clear();
+        regexBytes = 0;
+        for (std::sregex_iterator i(prefix.begin(), prefix.end(), wordRegex), end; i != end; ++i) {
+            regexBytes += (*i).str().size();
+            regexWords.emplace_back(static_cast<std::size_t>((*i).position()), static_cast<std::size_t>((*i).length()));
+        }
+    });
+    std::size_t index = 0;
+    forEachWord(prefix, [&](std::string_view word) {
+        const std::pair<std::size_t, std::size_t> found(static_cast<std::size_t>(word.data() - prefix.data()), word.size());
+        ok = ok && index < regexWords.size() && regexWords[index] == found;
+        ++index;
+    });
+    ok = ok && index == regexWords.size() && countWords(prefix) == regexWords.size();
+    doNotOptimize(regexBytes);
+    std::cout << "std::sregex_iterator on " << prefix.size() << " bytes: " << regexWords.size() << " words, "
+              << static_cast<double>(prefix.size()) / regexTime / 1e9 << " GB/s" << std::endl;
+
+    // Tokenizer on the whole text
+    const double gigabytes = static_cast<double>(text.size()) / 1e9;
+    std::size_t expectedCount = 0;
+    std::size_t expectedChecksum = 0;
+    forEachWord(text, [&](std::string_view word) {
+        expectedChecksum = mix(expectedChecksum, static_cast<std::size_t>(word.data() - text.data()), word.size());
+        ++expectedCount;
+    }, wordKernels(SimdLevel::Scalar));
+    std::cout << "Tokenizer on " << text.size() << " bytes, " << expectedCount << " words, GB/s:" << std::endl;
+    for (SimdLevel level : levels) {
+        const WordKernels& kernels = wordKernels(level);
+        std::size_t count = 0;
+        std::size_t checksum = 0;
+        double forEachTime = measureSeconds(3, [&] {
+            count = 0;
+            checksum = 0;
+            forEachWord(text, [&](std::string_view word) {
+                checksum = mix(checksum, static_cast<std::size_t>(word.data() - text.data()), word.size());
+                ++count;
+            }, kernels);
+        });
+        ok = ok && count == expectedCount && checksum == expectedChecksum;
+        double countTime = measureSeconds(3, [&] { count = countWords(text, kernels); });
+        ok = ok && count == expectedCount;
+        std::cout << "  " << std::setw(6) << simdLevelName(level) << ": forEachWord " << std::setw(7)
+                  << gigabytes / forEachTime << ", countWords " << std::setw(7) << gigabytes / countTime << std::endl;
+    }
+    std::size_t rangeCount = 0;
+    std::size_t rangeChecksum = 0;
+    double rangeTime = measureSeconds(3, [&] {
+        rangeCount = 0;
+        rangeChecksum = 0;
+        for (std::string_view word : WordTokenizer(text)) {
+            rangeChecksum = mix(rangeChecksum, static_cast<std::size_t>(word.data() - text.data()), word.size());
+            ++rangeCount;
+        }
+    });
+    ok = ok && rangeCount == expectedCount && rangeChecksum == expectedChecksum;
+    std::cout << "  WordTokenizer range (" << simdLevelName(simdLevel()) << "): " << gigabytes / rangeTime << std::endl;
+
+    // The same text from a memory-mapped file
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "word_tokenizer_benchmark.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!out) {
+            std::cerr << "Cannot write " << path << std::endl;
+            return 1;
+        }
+    }
+    {
+        MappedFile file(path.string(), MappedFileAccess::Sequential);
+        std::size_t count = 0;
+        std::size_t checksum = 0;
+        double mappedTime = measureSeconds(3, [&] {
+            count = 0;
+            checksum = 0;
+            forEachWord(file.text(), [&](std::string_view word) {
+                checksum = mix(checksum, static_cast<std::size_t>(word.data() - file.text().data()), word.size());
+                ++count;
+            });
+        });
+        ok = ok && count == expectedCount && checksum == expectedChecksum;
+        std::cout << "  forEachWord on the memory-mapped file (page cache warm): " << gigabytes / mappedTime << std::endl;
+    }
+    std::filesystem::remove(path);
+
+    std::cout << (ok ? "All methods find the same words." : "Results differ!") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,8 @@
 #include <vector>
 #include <algorithm>
 
+#include "../1.STL/Buffered_Output.h"
+
 int main() {
     // 1. Basic Lambda
     auto greet = []() {
@@ -49,16 +51,14 @@ int main() {
         return a > b;
     });
     std::cout << "Sorted vector (descending): ";
-    for (int n : nums) std::cout << n << " ";
-    std::cout << std::endl;
+    writeLine(standardOutput(), nums);
 
     // Multiply each element by 2 using for_each
     std::for_each(nums.begin(), nums.end(), [](int& n) {
         n *= 2;
     });
     std::cout << "Vector after multiplying elements by 2: ";
-    for (int n : nums) std::cout << n << " ";
-    std::cout << std::endl;
+    writeLine(standardOutput(), nums);
 
     // 7. Generic Lambda (C++14)
     auto print = [](auto value) {
@@ -1,6 +1,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "../1.STL/String_Concat.h"
+
 using ::std::string;
 using ::std::shared_ptr;
 using ::testing::Return;
@@ -53,7 +55,7 @@ public:
             return "Error: Invalid user age";
         }
 
-        return name + ", Age: " + std::to_string(age);
+        return concat(name, ", Age: ", age); // One allocation instead of three temporaries
     }
 };
 